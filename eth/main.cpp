@@ -39,6 +39,7 @@
 #if ETH_JSONRPC
 #include <libweb3jsonrpc/WebThreeStubServer.h>
 #include <libweb3jsonrpc/CorsHttpServer.h>
+#include <libweb3jsonrpc/ConcurrentHttpServer.h>
 #endif
 #include "BuildInfo.h"
 using namespace std;
@@ -90,6 +91,7 @@ void interactiveHelp()
 		<< "    inspect <contract>  Dumps a contract to <APPDATA>/<contract>.evm." << endl
 		<< "    dumptrace <block> <index> <filename> <format>  Dumps a transaction trace" << endl << "to <filename>. <format> should be one of pretty, standard, standard+." << endl
 		<< "    dumpreceipt <block> <index>  Dumps a transation receipt." << endl
+		<< "    dbstats  Shows the size of each database and LevelDB's statistics for it." << endl
 		<< "    exit  Exits the application." << endl;
 }
 
@@ -103,16 +105,23 @@ void help()
         << "    -c,--client-name <name>  Add a name to your client's version string (default: blank)." << endl
         << "    -d,--db-path <path>  Load database from path (default:  ~/.ethereum " << endl
         << "                         <APPDATA>/Etherum or Library/Application Support/Ethereum)." << endl
+		<< "    --db-cache <MB>  Size of the cache of each database (default: 32)." << endl
+		<< "    --db-bloom-bits <bits>  Bits per key of each database's bloom filter; 0 for none (default: 10)." << endl
+		<< "    --db-compression <on/off>  Compress the databases on disk (default: on)." << endl
+		<< "    --db-max-open-files <number>  Most files each database keeps open (default: 500)." << endl
+		<< "    --db-write-buffer <MB>  Size of the write buffer of each database (default: 4)." << endl
 		<< "    -f,--force-mining  Mine even when there are no transaction to mine (Default: off)" << endl
 		<< "    -h,--help  Show this help message and exit." << endl
         << "    -i,--interactive  Enter interactive mode (default: non-interactive)." << endl
 #if ETH_JSONRPC
 		<< "    -j,--json-rpc  Enable JSON-RPC server (default: off)." << endl
 		<< "    --json-rpc-port  Specify JSON-RPC server port (implies '-j', default: 8080)." << endl
+		<< "    --json-rpc-threads <number>  Serve JSON-RPC (and batches of requests) on the given number of threads (default: 0, a single server)." << endl
 #endif
         << "    -l,--listen <port>  Listen on the given port for incoming connected (default: 30303)." << endl
 		<< "    -m,--mining <on/off/number>  Enable mining, optionally for a specified number of blocks (Default: off)" << endl
 		<< "    -n,--upnp <on/off>  Use upnp for NAT (default: on)." << endl
+		<< "    --network-threads <number>  Use the given number of threads for network I/O (Default: 1)." << endl
 		<< "    -L,--local-networking Use peers whose addresses are local." << endl
 		<< "    -o,--mode <full/peer>  Start a full node or a peer node (Default: full)." << endl
         << "    -p,--port <port>  Connect to remote port (default: 30303)." << endl
@@ -182,9 +191,12 @@ int main(int argc, char** argv)
 	unsigned mining = ~(unsigned)0;
 	NodeMode mode = NodeMode::Full;
 	unsigned peers = 5;
+	unsigned networkThreads = 1;
+	DatabaseProfile dbProfile;
 	bool interactive = false;
 #if ETH_JSONRPC
 	int jsonrpc = -1;
+	unsigned jsonrpcThreads = 0;
 #endif
 	string publicIP;
 	bool bootstrap = false;
@@ -249,6 +261,27 @@ int main(int argc, char** argv)
 			us = KeyPair(h256(fromHex(argv[++i])));
 		else if ((arg == "-d" || arg == "--path" || arg == "--db-path") && i + 1 < argc)
 			dbPath = argv[++i];
+		else if (arg == "--db-cache" && i + 1 < argc)
+			dbProfile.cacheMB = atoi(argv[++i]);
+		else if (arg == "--db-bloom-bits" && i + 1 < argc)
+			dbProfile.bloomBits = atoi(argv[++i]);
+		else if (arg == "--db-write-buffer" && i + 1 < argc)
+			dbProfile.writeBufferMB = max(1, atoi(argv[++i]));
+		else if (arg == "--db-max-open-files" && i + 1 < argc)
+			dbProfile.maxOpenFiles = max(64, atoi(argv[++i]));
+		else if (arg == "--db-compression" && i + 1 < argc)
+		{
+			string m = argv[++i];
+			if (isTrue(m))
+				dbProfile.compression = true;
+			else if (isFalse(m))
+				dbProfile.compression = false;
+			else
+			{
+				cerr << "Invalid --db-compression option: " << m << endl;
+				return -1;
+			}
+		}
 		else if ((arg == "-m" || arg == "--mining") && i + 1 < argc)
 		{
 			string m = argv[++i];
@@ -275,11 +308,15 @@ int main(int argc, char** argv)
 			jsonrpc = jsonrpc == -1 ? 8080 : jsonrpc;
 		else if (arg == "--json-rpc-port" && i + 1 < argc)
 			jsonrpc = atoi(argv[++i]);
+		else if (arg == "--json-rpc-threads" && i + 1 < argc)
+			jsonrpcThreads = max(0, atoi(argv[++i]));
 #endif
 		else if ((arg == "-v" || arg == "--verbosity") && i + 1 < argc)
 			g_logVerbosity = atoi(argv[++i]);
 		else if ((arg == "-x" || arg == "--peers") && i + 1 < argc)
 			peers = atoi(argv[++i]);
+		else if (arg == "--network-threads" && i + 1 < argc)
+			networkThreads = max(1, atoi(argv[++i]));
 		else if ((arg == "-o" || arg == "--mode") && i + 1 < argc)
 		{
 			string m = argv[++i];
@@ -306,7 +343,9 @@ int main(int argc, char** argv)
 
 	cout << credits();
 
+	Defaults::setDatabaseProfile(dbProfile);
 	NetworkPreferences netPrefs(listenPort, publicIP, upnp, useLocal);
+	netPrefs.ioThreads = networkThreads;
 	dev::WebThreeDirect web3(
 		"Ethereum(++)/" + clientName + "v" + dev::Version + "/" DEV_QUOTED(ETH_BUILD_TYPE) "/" DEV_QUOTED(ETH_BUILD_PLATFORM),
 		dbPath,
@@ -339,7 +378,7 @@ int main(int argc, char** argv)
 	unique_ptr<jsonrpc::AbstractServerConnector> jsonrpcConnector;
 	if (jsonrpc > -1)
 	{
-		jsonrpcConnector = unique_ptr<jsonrpc::AbstractServerConnector>(new jsonrpc::HttpServer(jsonrpc));
+		jsonrpcConnector = unique_ptr<jsonrpc::AbstractServerConnector>(jsonrpcThreads ? (jsonrpc::AbstractServerConnector*)new jsonrpc::ConcurrentHttpServer(jsonrpc, jsonrpcThreads) : new jsonrpc::HttpServer(jsonrpc));
 		jsonrpcServer = shared_ptr<WebThreeStubServer>(new WebThreeStubServer(*jsonrpcConnector.get(), web3, vector<KeyPair>({us})));
 		jsonrpcServer->setIdentities({us});
 		jsonrpcServer->StartListening();
@@ -428,7 +467,7 @@ int main(int argc, char** argv)
 			{
 				if (jsonrpc < 0)
 					jsonrpc = 8080;
-				jsonrpcConnector = unique_ptr<jsonrpc::AbstractServerConnector>(new jsonrpc::HttpServer(jsonrpc));
+				jsonrpcConnector = unique_ptr<jsonrpc::AbstractServerConnector>(jsonrpcThreads ? (jsonrpc::AbstractServerConnector*)new jsonrpc::ConcurrentHttpServer(jsonrpc, jsonrpcThreads) : new jsonrpc::HttpServer(jsonrpc));
 				jsonrpcServer = shared_ptr<WebThreeStubServer>(new WebThreeStubServer(*jsonrpcConnector.get(), web3, vector<KeyPair>({us})));
 				jsonrpcServer->setIdentities({us});
 				jsonrpcServer->StartListening();
@@ -453,6 +492,10 @@ int main(int argc, char** argv)
 			{
 				cout << "Current block: " <<c->blockChain().details().number << endl;
 			}
+			else if (c && cmd == "dbstats")
+			{
+				cout << c->databaseStats();
+			}
 			else if (cmd == "peers")
 			{
 				for (auto it: web3.peers())
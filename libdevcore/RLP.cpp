@@ -71,6 +71,20 @@ RLP RLP::operator[](unsigned _i) const
 	return RLP(m_lastItem);
 }
 
+RLPIndex::RLPIndex(RLP const& _list):
+	m_data(_list.data())
+{
+	if (!_list.isList())
+	{
+		m_offsets.push_back(0);
+		return;
+	}
+	unsigned end = _list.payload().data() - _list.data().data();
+	m_offsets.push_back(end);
+	for (auto const& i: _list)
+		m_offsets.push_back(end += i.data().size());
+}
+
 RLPs RLP::toList() const
 {
 	RLPs ret;
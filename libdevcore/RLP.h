@@ -317,6 +317,30 @@ private:
 	mutable bytesConstRef m_lastItem;
 };
 
+/**
+ * @brief A one-pass index of the items of an RLP list.
+ *
+ * RLP::operator[] is cheap only when items are visited in ascending order and itemCount() rescans the whole list,
+ * so code that needs the count and random access to a large list (e.g. a packet of blocks) should build one of
+ * these first. Only item offsets are recorded; the data is not copied and must outlive the index.
+ */
+class RLPIndex
+{
+public:
+	/// Indexes the items of @a _list. If it's not a list, the index is empty.
+	explicit RLPIndex(RLP const& _list);
+
+	/// @returns the number of items in the list.
+	unsigned itemCount() const { return m_offsets.size() - 1; }
+
+	/// @returns the item @a _i of the list, or a null RLP if there's no such item.
+	RLP operator[](unsigned _i) const { return _i < itemCount() ? RLP(m_data.cropped(m_offsets[_i], m_offsets[_i + 1] - m_offsets[_i])) : RLP(); }
+
+private:
+	bytesConstRef m_data;				///< The list's data.
+	std::vector<unsigned> m_offsets;	///< Offset into m_data of each item, followed by the end of the last.
+};
+
 /**
  * @brief Class for writing to an RLP bytestream.
  */
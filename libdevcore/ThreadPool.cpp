@@ -0,0 +1,132 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ThreadPool.cpp
+ * @date 2014
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include "Log.h"
+using namespace std;
+using namespace dev;
+
+ThreadPool::ThreadPool(unsigned _threads, string const& _name)
+{
+	for (unsigned i = 0; i < _threads; ++i)
+		m_threads.push_back(thread([=]()
+		{
+			setThreadName(_name.c_str());
+			run();
+		}));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		Guard l(x_jobs);
+		m_stop = true;
+	}
+	m_jobsChanged.notify_all();
+	for (auto& t: m_threads)
+		t.join();
+}
+
+void ThreadPool::run()
+{
+	while (true)
+	{
+		function<void()> job;
+		{
+			unique_lock<Mutex> l(x_jobs);
+			m_jobsChanged.wait(l, [&](){ return m_stop || !m_jobs.empty(); });
+			if (m_stop)
+				return;
+			job = move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+		job();
+	}
+}
+
+void ThreadPool::post(function<void()> const& _job)
+{
+	{
+		Guard l(x_jobs);
+		m_jobs.push_back(_job);
+	}
+	m_jobsChanged.notify_one();
+}
+
+void ThreadPool::parallelFor(unsigned _n, function<void(unsigned)> const& _f)
+{
+	unsigned helpers = min<unsigned>(size(), _n ? _n - 1 : 0);
+	if (!helpers)
+	{
+		for (unsigned i = 0; i < _n; ++i)
+			_f(i);
+		return;
+	}
+
+	// Helpers that only get a thread once we're done must find nothing to do and not touch _f, which by then may be
+	// gone; hence the shared state, and the count of helpers still at work that we wait on before returning.
+	struct Shared
+	{
+		atomic<unsigned> next{0};
+		Mutex x;
+		condition_variable finished;
+		unsigned working = 0;
+		bool closed = false;
+	};
+	auto s = make_shared<Shared>();
+	auto f = &_f;
+	auto work = [=]()
+	{
+		for (unsigned i = s->next++; i < _n; i = s->next++)
+			(*f)(i);
+	};
+
+	for (unsigned i = 0; i < helpers; ++i)
+		post([=]()
+		{
+			{
+				Guard l(s->x);
+				if (s->closed)
+					return;
+				++s->working;
+			}
+			work();
+			{
+				Guard l(s->x);
+				--s->working;
+			}
+			s->finished.notify_all();
+		});
+
+	work();
+	unique_lock<Mutex> l(s->x);
+	s->finished.wait(l, [&](){ return !s->working; });
+	s->closed = true;
+}
+
+ThreadPool& ThreadPool::shared()
+{
+	static ThreadPool s_pool(max(thread::hardware_concurrency(), 1u) - 1, "pool");
+	return s_pool;
+}
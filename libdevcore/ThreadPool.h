@@ -0,0 +1,70 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ThreadPool.h
+ * @date 2014
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Guards.h"
+
+namespace dev
+{
+
+/**
+ * @brief A fixed set of long-lived threads which run the jobs posted to them, oldest first.
+ *
+ * Jobs should not block waiting on one another, since a job only gets a thread once one is free. parallelFor() can
+ * be used from anywhere, including from within a job, as its caller does whatever work no pool thread has taken.
+ */
+class ThreadPool
+{
+public:
+	explicit ThreadPool(unsigned _threads, std::string const& _name = "pool");
+	~ThreadPool();
+
+	/// @returns the number of threads in the pool; may be 0, in which case posted jobs never run.
+	unsigned size() const { return m_threads.size(); }
+
+	/// Queue @a _job to be run on the next free thread of the pool. Thread-safe.
+	void post(std::function<void()> const& _job);
+
+	/// Call @a _f with each of 0 to @a _n - 1, on this thread together with whichever pool threads are free; returns
+	/// once all calls have returned. @a _f must not throw. Thread-safe.
+	void parallelFor(unsigned _n, std::function<void(unsigned)> const& _f);
+
+	/// @returns the process-wide pool, of one thread fewer than the machine has cores.
+	static ThreadPool& shared();
+
+private:
+	void run();
+
+	std::vector<std::thread> m_threads;
+
+	Mutex x_jobs;
+	std::condition_variable m_jobsChanged;
+	std::deque<std::function<void()>> m_jobs;
+	bool m_stop = false;
+};
+
+}
@@ -42,7 +42,11 @@ void Worker::startWorking()
 		while (!m_stop)
 		{
 			if (m_idleWaitMs)
-				this_thread::sleep_for(chrono::milliseconds(m_idleWaitMs));
+			{
+				unique_lock<Mutex> l(x_wake);
+				m_wake.wait_for(l, chrono::milliseconds(m_idleWaitMs), [&](){ return m_woken || m_stop; });
+				m_woken = false;
+			}
 			doWork();
 		}
 		cdebug << "Finishing up worker thread";
@@ -58,8 +62,18 @@ void Worker::stopWorking()
 		return;
 	cdebug << "Stopping" << m_name;
 	m_stop = true;
+	wake();
 	m_work->join();
 	m_work.reset();
 	cdebug << "Stopped" << m_name;
 }
 
+void Worker::wake()
+{
+	{
+		Guard l(x_wake);
+		m_woken = true;
+	}
+	m_wake.notify_all();
+}
+
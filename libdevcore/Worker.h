@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <string>
 #include <thread>
 #include "Guards.h"
@@ -34,10 +36,10 @@ protected:
 	Worker(std::string const& _name = "anon", unsigned _idleWaitMs = 30): m_name(_name), m_idleWaitMs(_idleWaitMs) {}
 
 	/// Move-constructor.
-	Worker(Worker&& _m) { std::swap(m_name, _m.m_name); }
+	Worker(Worker&& _m): m_idleWaitMs(_m.m_idleWaitMs) { std::swap(m_name, _m.m_name); }
 
 	/// Move-assignment.
-	Worker& operator=(Worker&& _m) { std::swap(m_name, _m.m_name); return *this; }
+	Worker& operator=(Worker&& _m) { std::swap(m_name, _m.m_name); std::swap(m_idleWaitMs, _m.m_idleWaitMs); return *this; }
 
 	virtual ~Worker() { stopWorking(); }
 
@@ -52,11 +54,14 @@ protected:
 	
 	/// Returns if worker thread is present.
 	bool isWorking() const { Guard l(x_work); return !!m_work; }
+
+	/// Cuts short the worker thread's current (or next) idle wait, so doWork() gets called straight away. Thread-safe.
+	void wake();
 	
 	/// Called after thread is started from startWorking().
 	virtual void startedWorking() {}
 	
-	/// Called continuously following sleep for m_idleWaitMs.
+	/// Called continuously, each time following a wait of up to m_idleWaitMs that is ended early by wake().
 	virtual void doWork() = 0;
 	
 	/// Called when is to be stopped, just prior to thread being joined.
@@ -68,7 +73,11 @@ private:
 	
 	mutable Mutex x_work;						///< Lock for the network existance.
 	std::unique_ptr<std::thread> m_work;		///< The network thread.
-	bool m_stop = false;
+	std::atomic<bool> m_stop{false};
+
+	Mutex x_wake;								///< Lock for m_woken.
+	std::condition_variable m_wake;				///< Signalled by wake() and stopWorking().
+	bool m_woken = false;						///< True if wake() has been called since the last idle wait ended.
 };
 
 }
@@ -23,6 +23,9 @@
 #include <random>
 #include <chrono>
 #include <mutex>
+#if ETH_HAVE_SECP256K1
+#include <secp256k1/secp256k1.h>
+#endif
 #include "SHA3.h"
 #include "FileSystem.h"
 #include "CryptoPP.h"
@@ -33,6 +36,15 @@ using namespace dev::crypto;
 
 static Secp256k1 s_secp256k1;
 
+#if ETH_HAVE_SECP256K1
+/// Builds libsecp256k1's tables the first time they're needed; the library is thread-safe thereafter.
+static void requireSecp256k1()
+{
+	static bool s_started = (secp256k1_start(), true);
+	(void)s_started;
+}
+#endif
+
 bool dev::SignatureStruct::isValid()
 {
 	if (this->v > 1 ||
@@ -45,7 +57,15 @@ bool dev::SignatureStruct::isValid()
 Public dev::toPublic(Secret const& _secret)
 {
 	Public p;
+#if ETH_HAVE_SECP256K1
+	requireSecp256k1();
+	byte pubkey[65];
+	int pubkeylen = 65;
+	if (secp256k1_ecdsa_pubkey_create(pubkey, &pubkeylen, _secret.data(), 0) && pubkeylen == 65)
+		memcpy(p.data(), pubkey + 1, 64);
+#else
 	s_secp256k1.toPublic(_secret, p);
+#endif
 	return std::move(p);
 }
 
@@ -56,9 +76,7 @@ Address dev::toAddress(Public const& _public)
 
 Address dev::toAddress(Secret const& _secret)
 {
-	Public p;
-	s_secp256k1.toPublic(_secret, p);
-	return s_secp256k1.toAddress(p);
+	return s_secp256k1.toAddress(toPublic(_secret));
 }
 
 void dev::encrypt(Public const& _k, bytesConstRef _plain, bytes& o_cipher)
@@ -80,17 +98,52 @@ bool dev::decrypt(Secret const& _k, bytesConstRef _cipher, bytes& o_plaintext)
 
 Public dev::recover(Signature const& _sig, h256 const& _message)
 {
+#if ETH_HAVE_SECP256K1
+	requireSecp256k1();
+	Public ret;
+	byte pubkey[65];
+	int pubkeylen = 65;
+	if (_sig[64] <= 1 && secp256k1_ecdsa_recover_compact(_message.data(), 32, _sig.data(), pubkey, &pubkeylen, 0, _sig[64]) && pubkeylen == 65)
+		memcpy(ret.data(), pubkey + 1, 64);
+	return ret;
+#else
 	return s_secp256k1.recover(_sig, _message.ref());
+#endif
 }
 
 Signature dev::sign(Secret const& _k, h256 const& _hash)
 {
+#if ETH_HAVE_SECP256K1
+	requireSecp256k1();
+	if (!secp256k1_ecdsa_seckey_verify(_k.data()))
+		BOOST_THROW_EXCEPTION(InvalidState());
+
+	// The nonce is derived as for the Crypto++ signer. In the (astronomically unlikely) case that it's out of range
+	// or gives a recovery id that doesn't fit in v, rehash it and try again.
+	h256 nonce = kdf(_k, _hash);
+	for (unsigned i = 0; i < 8; ++i, nonce = sha3(nonce))
+	{
+		Signature ret;
+		int v;
+		if (secp256k1_ecdsa_seckey_verify(nonce.data()) && secp256k1_ecdsa_sign_compact(_hash.data(), 32, ret.data(), _k.data(), nonce.data(), &v) && v <= 1)
+		{
+			ret[64] = (byte)v;
+			return ret;
+		}
+	}
+	BOOST_THROW_EXCEPTION(InvalidState());
+#else
 	return s_secp256k1.sign(_k, _hash);
+#endif
 }
 
 bool dev::verify(Public const& _p, Signature const& _s, h256 const& _hash)
 {
+#if ETH_HAVE_SECP256K1
+	return _p == recover(_s, _hash);
+#else
 	return s_secp256k1.verify(_p, _s, _hash.ref(), true);
+#endif
 }
 
 KeyPair KeyPair::create()
@@ -110,8 +163,17 @@ KeyPair KeyPair::create()
 KeyPair::KeyPair(h256 _sec):
 	m_secret(_sec)
 {
+#if ETH_HAVE_SECP256K1
+	requireSecp256k1();
+	if (secp256k1_ecdsa_seckey_verify(m_secret.data()))
+	{
+		m_public = toPublic(m_secret);
+		m_address = s_secp256k1.toAddress(m_public);
+	}
+#else
 	if (s_secp256k1.verifySecret(m_secret, m_public))
 		m_address = s_secp256k1.toAddress(m_public);
+#endif
 }
 
 KeyPair KeyPair::fromEncryptedSeed(bytesConstRef _seed, std::string const& _password)
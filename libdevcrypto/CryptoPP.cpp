@@ -147,13 +147,20 @@ Public Secp256k1::recover(Signature _signature, bytesConstRef _message)
 	encodedpoint[0] = _signature[64]|2;
 	memcpy(&encodedpoint[1], _signature.data(), 32);
 	
-	ECP::Element x;
+	// The curve's arithmetic uses scratch space within the object, so work on a private copy of it; that way the
+	// (expensive) multiplication below needn't hold x_curve and concurrent recoveries can run in parallel.
+	unique_ptr<ECP> curve;
+	ECP::Point g;
 	{
 		lock_guard<mutex> l(x_curve);
-		m_curve.DecodePoint(x, encodedpoint, 33);
-		if (!m_curve.VerifyPoint(x))
-			return recovered;
+		curve.reset(new ECP(m_curve));
+		g = m_params.GetSubgroupGenerator();
 	}
+
+	ECP::Element x;
+	curve->DecodePoint(x, encodedpoint, 33);
+	if (!curve->VerifyPoint(x))
+		return recovered;
 	
 //	if (_signature[64] & 2)
 //	{
@@ -168,14 +175,9 @@ Public Secp256k1::recover(Signature _signature, bytesConstRef _message)
 	Integer u1 = m_q - (rn.Times(z)).Modulo(m_q);
 	Integer u2 = (rn.Times(s)).Modulo(m_q);
 	
-	ECP::Point p;
+	ECP::Point p = curve->CascadeMultiply(u2, x, u1, g);
 	byte recoveredbytes[65];
-	{
-		lock_guard<mutex> l(x_curve);
-		// todo: make generator member
-		p = m_curve.CascadeMultiply(u2, x, u1, m_params.GetSubgroupGenerator());
-		m_curve.EncodePoint(recoveredbytes, p, false);
-	}
+	curve->EncodePoint(recoveredbytes, p, false);
 	memcpy(recovered.data(), &recoveredbytes[1], 64);
 	return recovered;
 }
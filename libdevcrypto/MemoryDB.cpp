@@ -29,12 +29,10 @@ namespace dev
 
 std::map<h256, std::string> MemoryDB::get() const
 {
-	if (!m_enforceRefs)
-		return m_over;
 	std::map<h256, std::string> ret;
-	for (auto const& i: m_refCount)
-		if (i.second)
-			ret.insert(*m_over.find(i.first));
+	for (auto const& i: m_over)
+		if (!m_enforceRefs || i.second.refCount)
+			ret.insert(make_pair(i.first, i.second.value));
 	return ret;
 }
 
@@ -43,8 +41,8 @@ std::string MemoryDB::lookup(h256 _h) const
 	auto it = m_over.find(_h);
 	if (it != m_over.end())
 	{
-		if (!m_enforceRefs || (m_refCount.count(it->first) && m_refCount.at(it->first)))
-			return it->second;
+		if (!m_enforceRefs || it->second.refCount)
+			return it->second.value;
 //		else if (m_enforceRefs && m_refCount.count(it->first) && !m_refCount.at(it->first))
 //			cnote << "Lookup required for value with no refs. Let's hope it's in the DB." << _h.abridged();
 	}
@@ -54,26 +52,30 @@ std::string MemoryDB::lookup(h256 _h) const
 bool MemoryDB::exists(h256 _h) const
 {
 	auto it = m_over.find(_h);
-	if (it != m_over.end() && (!m_enforceRefs || (m_refCount.count(it->first) && m_refCount.at(it->first))))
+	if (it != m_over.end() && (!m_enforceRefs || it->second.refCount))
 		return true;
 	return false;
 }
 
 void MemoryDB::insert(h256 _h, bytesConstRef _v)
 {
-	m_over[_h] = _v.toString();
-	m_refCount[_h]++;
+	RefCounted& n = m_over[_h];
+	// Keys are the hashes of their values, so a live node's value needn't be rewritten.
+	if (!n.refCount)
+		n.value = _v.toString();
+	n.refCount++;
 #if ETH_PARANOIA
-	dbdebug << "INST" << _h.abridged() << "=>" << m_refCount[_h];
+	dbdebug << "INST" << _h.abridged() << "=>" << n.refCount;
 #endif
 }
 
 bool MemoryDB::kill(h256 _h)
 {
-	if (m_refCount.count(_h))
+	auto it = m_over.find(_h);
+	if (it != m_over.end())
 	{
-		if (m_refCount[_h] > 0)
-			--m_refCount[_h];
+		if (it->second.refCount > 0)
+			--it->second.refCount;
 #if ETH_PARANOIA
 		else
 		{
@@ -82,7 +84,7 @@ bool MemoryDB::kill(h256 _h)
 			dbdebug << "NOKILL-WAS" << _h.abridged();
 			return false;
 		}
-		dbdebug << "KILL" << _h.abridged() << "=>" << m_refCount[_h];
+		dbdebug << "KILL" << _h.abridged() << "=>" << it->second.refCount;
 		return true;
 	}
 	else
@@ -98,16 +100,18 @@ bool MemoryDB::kill(h256 _h)
 
 void MemoryDB::purge()
 {
-	for (auto const& i: m_refCount)
-		if (!i.second)
-			m_over.erase(i.first);
+	for (auto it = m_over.begin(); it != m_over.end();)
+		if (!it->second.refCount)
+			it = m_over.erase(it);
+		else
+			++it;
 }
 
 set<h256> MemoryDB::keys() const
 {
 	set<h256> ret;
-	for (auto const& i: m_refCount)
-		if (i.second)
+	for (auto const& i: m_over)
+		if (i.second.refCount)
 			ret.insert(i.first);
 	return ret;
 }
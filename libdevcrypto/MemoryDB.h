@@ -22,6 +22,7 @@
 #pragma once
 
 #include <map>
+#include <unordered_map>
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/Log.h>
@@ -53,8 +54,14 @@ public:
 	std::set<h256> keys() const;
 
 protected:
-	std::map<h256, std::string> m_over;
-	std::map<h256, unsigned> m_refCount;
+	/// A node's data and its reference count, kept together so each node costs a single hash-table entry.
+	struct RefCounted
+	{
+		std::string value;
+		unsigned refCount = 0;
+	};
+
+	std::unordered_map<h256, RefCounted> m_over;
 
 	mutable bool m_enforceRefs = false;
 };
@@ -0,0 +1,75 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file NodeCache.cpp
+ * @date 2014
+ */
+
+#include "NodeCache.h"
+using namespace std;
+using namespace dev;
+
+bool NodeCache::lookup(h256 const& _h, string& o_value)
+{
+	Guard l(x_cache);
+	auto it = m_index.find(_h);
+	if (it == m_index.end())
+	{
+		++m_misses;
+		return false;
+	}
+	++m_hits;
+	m_entries.splice(m_entries.begin(), m_entries, it->second);
+	o_value = it->second->second;
+	return true;
+}
+
+void NodeCache::insert(h256 const& _h, string const& _value)
+{
+	if (_value.empty() || _value.size() > m_capacity)
+		return;
+
+	Guard l(x_cache);
+	auto it = m_index.find(_h);
+	if (it != m_index.end())
+	{
+		// Same hash, same content; just freshen it.
+		m_entries.splice(m_entries.begin(), m_entries, it->second);
+		return;
+	}
+
+	m_entries.emplace_front(_h, _value);
+	m_index[_h] = m_entries.begin();
+	m_size += _value.size();
+
+	while (m_size > m_capacity)
+	{
+		auto& last = m_entries.back();
+		m_size -= last.second.size();
+		m_index.erase(last.first);
+		m_entries.pop_back();
+	}
+}
+
+void NodeCache::clear()
+{
+	Guard l(x_cache);
+	m_entries.clear();
+	m_index.clear();
+	m_size = 0;
+	m_hits = 0;
+	m_misses = 0;
+}
@@ -0,0 +1,76 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file NodeCache.h
+ * @date 2014
+ */
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+
+namespace dev
+{
+
+/**
+ * @brief A bounded, least-recently-used cache of trie nodes read from the backing database.
+ *
+ * Nodes are keyed by the SHA3 of their content, so an entry can never go stale and needs no invalidation. The
+ * bound is on the total size of the cached node data, not the number of nodes. Thread-safe; it's meant to be
+ * shared between all the OverlayDBs (and so all the States) sitting on the same database.
+ */
+class NodeCache
+{
+public:
+	/// Default limit of total node data held: 32 MB.
+	static const size_t DefaultCapacity = 32 * 1024 * 1024;
+
+	explicit NodeCache(size_t _capacity = DefaultCapacity): m_capacity(_capacity) {}
+
+	/// Look up @a _h, placing its data in @a o_value and marking it most recently used.
+	/// @returns true on a hit. Counts towards hits() or misses().
+	bool lookup(h256 const& _h, std::string& o_value);
+
+	/// Note @a _value as the data of node @a _h, evicting the least recently used nodes as necessary.
+	void insert(h256 const& _h, std::string const& _value);
+
+	/// Forget all nodes and reset the counters.
+	void clear();
+
+	size_t capacity() const { return m_capacity; }
+	size_t size() const { Guard l(x_cache); return m_size; }
+	unsigned count() const { Guard l(x_cache); return m_index.size(); }
+	uint64_t hits() const { Guard l(x_cache); return m_hits; }
+	uint64_t misses() const { Guard l(x_cache); return m_misses; }
+
+private:
+	typedef std::list<std::pair<h256, std::string>> Entries;
+
+	size_t const m_capacity;
+
+	mutable Mutex x_cache;
+	Entries m_entries;										///< Most recently used at the front.
+	std::unordered_map<h256, Entries::iterator> m_index;	///< Where each cached node lives in m_entries.
+	size_t m_size = 0;										///< Total bytes of node data in m_entries.
+	uint64_t m_hits = 0;
+	uint64_t m_misses = 0;
+};
+
+}
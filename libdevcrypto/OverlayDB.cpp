@@ -19,6 +19,11 @@
  * @date 2014
  */
 
+#pragma warning(push)
+#pragma warning(disable: 4100 4267)
+#include <leveldb/write_batch.h>
+#pragma warning(pop)
+
 #include <libdevcore/Common.h>
 #include "OverlayDB.h"
 using namespace std;
@@ -36,6 +41,7 @@ OverlayDB::~OverlayDB()
 void OverlayDB::setDB(ldb::DB* _db, bool _clearOverlay)
 {
 	m_db = std::shared_ptr<ldb::DB>(_db);
+	m_cache = _db ? make_shared<NodeCache>() : nullptr;
 	if (_clearOverlay)
 		m_over.clear();
 }
@@ -45,28 +51,43 @@ void OverlayDB::commit()
 	if (m_db)
 	{
 //		cnote << "Committing nodes to disk DB:";
+		ldb::WriteBatch batch;
 		for (auto const& i: m_over)
 		{
-//			cnote << i.first << "#" << m_refCount[i.first];
-			if (m_refCount[i.first])
-				m_db->Put(m_writeOptions, ldb::Slice((char const*)i.first.data(), i.first.size), ldb::Slice(i.second.data(), i.second.size()));
+//			cnote << i.first << "#" << i.second.refCount;
+			if (i.second.refCount)
+				batch.Put(ldb::Slice((char const*)i.first.data(), i.first.size), ldb::Slice(i.second.value.data(), i.second.value.size()));
 		}
+		m_db->Write(m_writeOptions, &batch);
+
+		// Freshly written nodes (the upper levels of the new state trie especially) are the likeliest to be read next.
+		for (auto const& i: m_over)
+			if (i.second.refCount)
+				m_cache->insert(i.first, i.second.value);
 		m_over.clear();
-		m_refCount.clear();
 	}
 }
 
 void OverlayDB::rollback()
 {
 	m_over.clear();
-	m_refCount.clear();
 }
 
 std::string OverlayDB::lookup(h256 _h) const
 {
 	std::string ret = MemoryDB::lookup(_h);
 	if (ret.empty() && m_db)
-		m_db->Get(m_readOptions, ldb::Slice((char const*)_h.data(), 32), &ret);
+		ret = lookupDB(_h);
+	return ret;
+}
+
+std::string OverlayDB::lookupDB(h256 const& _h) const
+{
+	std::string ret;
+	if (m_cache->lookup(_h, ret))
+		return ret;
+	m_db->Get(m_readOptions, ldb::Slice((char const*)_h.data(), 32), &ret);
+	m_cache->insert(_h, ret);
 	return ret;
 }
 
@@ -74,10 +95,7 @@ bool OverlayDB::exists(h256 _h) const
 {
 	if (MemoryDB::exists(_h))
 		return true;
-	std::string ret;
-	if (m_db)
-		m_db->Get(m_readOptions, ldb::Slice((char const*)_h.data(), 32), &ret);
-	return !ret.empty();
+	return m_db && !lookupDB(_h).empty();
 }
 
 void OverlayDB::kill(h256 _h)
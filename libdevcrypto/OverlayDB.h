@@ -30,6 +30,7 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/Log.h>
 #include "MemoryDB.h"
+#include "NodeCache.h"
 namespace ldb = leveldb;
 
 namespace dev
@@ -38,15 +39,22 @@ namespace dev
 class OverlayDB: public MemoryDB
 {
 public:
-	OverlayDB(ldb::DB* _db = nullptr): m_db(_db) {}
+	OverlayDB(ldb::DB* _db = nullptr): m_db(_db), m_cache(_db ? std::make_shared<NodeCache>() : nullptr) {}
 	~OverlayDB();
 
 	ldb::DB* db() const { return m_db.get(); }
 	void setDB(ldb::DB* _db, bool _clearOverlay = true);
 
+	/// @returns the cache of nodes read from the DB, shared by all copies of this overlay; null if there's no DB.
+	NodeCache* nodeCache() const { return m_cache.get(); }
+
+	/// Write all live nodes of the overlay to the DB, as a single batch, and clear the overlay.
 	void commit();
 	void rollback();
 
+	/// Set whether commit() waits for its batch to reach stable storage before returning. Off by default.
+	void setSyncCommits(bool _sync) { m_writeOptions.sync = _sync; }
+
 	std::string lookup(h256 _h) const;
 	bool exists(h256 _h) const;
 	void kill(h256 _h);
@@ -54,7 +62,11 @@ public:
 private:
 	using MemoryDB::clear;
 
+	/// @returns the data of node @a _h as stored in the DB (going through the node cache), or empty if it's not there.
+	std::string lookupDB(h256 const& _h) const;
+
 	std::shared_ptr<ldb::DB> m_db;
+	std::shared_ptr<NodeCache> m_cache;		///< Recently read nodes of m_db; shared, like m_db, between copies.
 
 	ldb::ReadOptions m_readOptions;
 	ldb::WriteOptions m_writeOptions;
@@ -26,6 +26,7 @@
 #include <chrono>
 #include <thread>
 #include <cstdint>
+#include <random>
 #include <libdevcrypto/SHA3.h>
 #include "CommonEth.h"
 
@@ -51,10 +52,21 @@ class ProofOfWorkEngine: public Evaluator
 public:
 	static bool verify(h256 const& _root, h256 const& _nonce, u256 const& _difficulty) { return (bigint)(u256)Evaluator::eval(_root, _nonce) <= (bigint(1) << 256) / _difficulty; }
 
+	/// @returns the greatest hash acceptable at difficulty @a _difficulty, as a big-endian 256-bit value.
+	static h256 boundary(u256 const& _difficulty) { return _difficulty > 1 ? h256(u256((bigint(1) << 256) / _difficulty)) : h256(~u256(0)); }
+
+	/// Restrict the nonces tried to those whose top 32 bits are @a _partition. Engines (e.g. one per thread) mining the
+	/// same block with different partitions never duplicate each other's work.
+	void setPartition(uint32_t _partition) { m_partition = _partition; m_root = h256(); }
+
 	inline MineInfo mine(h256& o_solution, h256 const& _root, u256 const& _difficulty, unsigned _msTimeout = 100, bool _continue = true, bool _turbo = false);
 
 protected:
-	h256 m_last;
+	uint32_t m_partition = 0;	///< The top 32 bits of every nonce we try.
+	h256 m_root;				///< The header hash we were last mining on.
+	h256 m_nonce;				///< The next nonce to try on m_root.
+	u256 m_difficulty;			///< The difficulty for which m_boundary was calculated.
+	h256 m_boundary;			///< The greatest acceptable hash at m_difficulty.
 };
 
 class SHA3Evaluator
@@ -82,11 +94,27 @@ template <class Evaluator>
 MineInfo ProofOfWorkEngine<Evaluator>::mine(h256& o_solution, h256 const& _root, u256 const& _difficulty, unsigned _msTimeout, bool _continue, bool _turbo)
 {
 	MineInfo ret;
-	static std::mt19937_64 s_eng((time(0) + (unsigned)m_last));
-	u256 s = (m_last = h256::random(s_eng));
 
-	bigint d = (bigint(1) << 256) / _difficulty;
-	ret.requirement = log2((double)d);
+	if (_difficulty != m_difficulty || !m_boundary)
+	{
+		m_difficulty = _difficulty;
+		m_boundary = boundary(_difficulty);
+	}
+	ret.requirement = log2((double)(u256)m_boundary);
+
+	// Nonces are laid out as [ partition (4 bytes) | random (20 bytes) | counter (8 bytes) ]. A new header gets a new
+	// random middle; the same header carries on counting from where we left off.
+	if (_root != m_root)
+	{
+		m_root = _root;
+		std::random_device rd;
+		for (unsigned i = 4; i < 24; ++i)
+			m_nonce[i] = (byte)rd();
+		for (unsigned i = 24; i < 32; ++i)
+			m_nonce[i] = 0;
+		for (unsigned i = 0; i < 4; ++i)
+			m_nonce[i] = (byte)(m_partition >> (24 - 8 * i));
+	}
 
 	// 2^ 0      32      64      128      256
 	//   [--------*-------------------------]
@@ -95,17 +123,28 @@ MineInfo ProofOfWorkEngine<Evaluator>::mine(h256& o_solution, h256 const& _root,
 	auto startTime = std::chrono::steady_clock::now();
 	if (!_turbo)
 		std::this_thread::sleep_for(std::chrono::milliseconds(_msTimeout * 90 / 100));
-	for (; (std::chrono::steady_clock::now() - startTime) < std::chrono::milliseconds(_msTimeout) && _continue; s++, ret.hashes++)
-	{
-		o_solution = (h256)s;
-		auto e = (bigint)(u256)Evaluator::eval(_root, o_solution);
-		ret.best = std::min<double>(ret.best, log2((double)e));
-		if (e <= d)
+
+	// Keep the inner loop to hashing and byte comparisons; only look at the clock every so often.
+	static const unsigned c_hashesPerCheck = 256;
+	h256 best = h256(~u256(0));
+	while (_continue && !ret.completed && (std::chrono::steady_clock::now() - startTime) < std::chrono::milliseconds(_msTimeout))
+		for (unsigned i = 0; i < c_hashesPerCheck; ++i)
 		{
-			ret.completed = true;
-			break;
+			h256 e = Evaluator::eval(_root, m_nonce);
+			++ret.hashes;
+			if (e < best)
+				best = e;
+			if (!(m_boundary < e))
+			{
+				o_solution = m_nonce;
+				ret.completed = true;
+				break;
+			}
+			for (unsigned j = 32; j-- > 24 && !++m_nonce[j];) {}
 		}
-	}
+
+	if (ret.hashes)
+		ret.best = log2((double)(u256)best);
 
 	if (ret.completed)
 		assert(verify(_root, o_solution, _difficulty));
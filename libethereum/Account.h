@@ -58,6 +58,10 @@ namespace eth
  *
  * @todo: need to make a noteCodeCommitted().
  *
+ * Every alteration marks the account as dirty; only dirty accounts need to be written back to the state trie on
+ * commit. Accounts read from the trie are constructed as Unchanged, and values looked up from the storage trie or
+ * the state database are recorded with noteStorage() and noteCode(), neither of which dirties the account.
+ *
  * The constructor allows you to create an one of a number of "types" of accounts. The default constructor
  * makes a dead account (this is ignored by State when writing out the Trie). Another three allow a basic
  * or contract account to be specified along with an initial balance. The fina two allow either a basic or
@@ -76,6 +80,15 @@ public:
 		ContractConception
 	};
 
+	/// Whether a newly constructed account differs from what's in the state trie.
+	enum Changedness
+	{
+		/// Account is new or altered, and must be written back.
+		Changed,
+		/// Account is as read from the state trie.
+		Unchanged
+	};
+
 	/// Construct a dead Account.
 	Account() {}
 
@@ -87,35 +100,38 @@ public:
 	Account(u256 _nonce, u256 _balance): m_isAlive(true), m_nonce(_nonce), m_balance(_balance) {}
 
 	/// Explicit constructor for wierd cases of construction or a contract account.
-	Account(u256 _nonce, u256 _balance, h256 _contractRoot, h256 _codeHash): m_isAlive(true), m_nonce(_nonce), m_balance(_balance), m_storageRoot(_contractRoot), m_codeHash(_codeHash) { assert(_contractRoot); }
+	Account(u256 _nonce, u256 _balance, h256 _contractRoot, h256 _codeHash, Changedness _c = Changed): m_isAlive(true), m_isUnchanged(_c == Unchanged), m_nonce(_nonce), m_balance(_balance), m_storageRoot(_contractRoot), m_codeHash(_codeHash) { assert(_contractRoot); }
 
 
 	/// Kill this account. Useful for the suicide opcode. Following this call, isAlive() returns false.
-	void kill() { m_isAlive = false; m_storageOverlay.clear(); m_codeHash = EmptySHA3; m_storageRoot = EmptyTrie; m_balance = 0; m_nonce = 0; }
+	void kill() { m_isAlive = false; m_storageOverlay.clear(); m_codeHash = EmptySHA3; m_storageRoot = EmptyTrie; m_balance = 0; m_nonce = 0; changed(); }
 
 	/// @returns true iff this object represents an account in the state. Returns false if this object
 	/// represents an account that should no longer exist in the trie (an account that never existed or was
 	/// suicided).
 	bool isAlive() const { return m_isAlive; }
 
+	/// @returns true if the account has been altered since it was read from the state trie (or was never in it).
+	bool isDirty() const { return !m_isUnchanged; }
+
 
-	/// @returns the balance of this account. Can be altered in place.
+	/// @returns the balance of this account. Can be altered in place, though doing so doesn't mark it dirty.
 	u256& balance() { return m_balance; }
 
 	/// @returns the balance of this account.
 	u256 const& balance() const { return m_balance; }
 
 	/// Increments the balance of this account by the given amount. It's a bigint, so can be negative.
-	void addBalance(bigint _i) { m_balance = (u256)((bigint)m_balance + _i); }
+	void addBalance(bigint _i) { m_balance = (u256)((bigint)m_balance + _i); changed(); }
 
-	/// @returns the nonce of the account. Can be altered in place.
+	/// @returns the nonce of the account. Can be altered in place, though doing so doesn't mark it dirty.
 	u256& nonce() { return m_nonce; }
 
 	/// @returns the nonce of the account.
 	u256 const& nonce() const { return m_nonce; }
 
 	/// Increment the nonce of the account by one.
-	void incNonce() { m_nonce++; }
+	void incNonce() { m_nonce++; changed(); }
 
 
 	/// @returns the root of the trie (whose nodes are stored in the state db externally to this class)
@@ -127,7 +143,13 @@ public:
 
 	/// Set a key/value pair in the account's storage. This actually goes into the overlay, for committing
 	/// to the trie later.
-	void setStorage(u256 _p, u256 _v) { m_storageOverlay[_p] = _v; }
+	void setStorage(u256 _p, u256 _v) { m_storageOverlay[_p] = _v; changed(); }
+
+	/// Record in the overlay the value of a key as it is in the storage trie. Doesn't mark the account dirty.
+	void noteStorage(u256 _p, u256 _v) { m_storageOverlay[_p] = _v; }
+
+	/// Drop a key from the account's storage overlay, so that its value once again comes from the trie.
+	void unsetStorage(u256 _p) { m_storageOverlay.erase(_p); }
 
 	/// @returns true if we are in the contract-conception state and setCode is valid to call.
 	bool isFreshCode() const { return m_codeHash == c_contractConceptionCodeHash; }
@@ -140,7 +162,7 @@ public:
 	h256 codeHash() const { assert(!isFreshCode()); return m_codeHash; }
 
 	/// Sets the code of the account. Must only be called when isFreshCode() returns true.
-	void setCode(bytesConstRef _code) { assert(isFreshCode()); m_codeCache = _code.toBytes(); }
+	void setCode(bytesConstRef _code) { assert(isFreshCode()); m_codeCache = _code.toBytes(); changed(); }
 
 	/// @returns true if the account's code is available through code().
 	bool codeCacheValid() const { return m_codeHash == EmptySHA3 || m_codeHash == c_contractConceptionCodeHash || m_codeCache.size(); }
@@ -153,9 +175,15 @@ public:
 	bytes const& code() const { assert(codeCacheValid()); return m_codeCache; }
 
 private:
+	/// Note that the account has been altered.
+	void changed() { m_isUnchanged = false; }
+
 	/// Is this account existant? If not, it represents a deleted account.
 	bool m_isAlive = false;
 
+	/// True if we've not made any alteration to the account since it was read from the trie.
+	bool m_isUnchanged = false;
+
 	/// Account's nonce.
 	u256 m_nonce = 0;
 
@@ -21,14 +21,17 @@
 
 #include "BlockChain.h"
 
+#include <condition_variable>
 #include <boost/filesystem.hpp>
 #include <libdevcore/Common.h>
 #include <libdevcore/RLP.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcrypto/FileSystem.h>
 #include <libethcore/Exceptions.h>
 #include <libethcore/ProofOfWork.h>
 #include <libethcore/BlockInfo.h>
 #include "State.h"
+#include "Transaction.h"
 #include "Defaults.h"
 using namespace std;
 using namespace dev;
@@ -36,6 +39,9 @@ using namespace dev::eth;
 
 #define ETH_CATCH 1
 
+/// How far ahead of execution the stateless checks of the blocks being imported by sync() may get.
+static const unsigned c_verifyAhead = 16;
+
 std::ostream& dev::eth::operator<<(std::ostream& _out, BlockChain const& _bc)
 {
 	string cmp = toBigEndianString(_bc.currentHash());
@@ -133,14 +139,8 @@ void BlockChain::open(std::string _path, bool _killExisting)
 		boost::filesystem::remove_all(_path + "/details");
 	}
 
-	ldb::Options o;
-	o.create_if_missing = true;
-	ldb::DB::Open(o, _path + "/blocks", &m_db);
-	ldb::DB::Open(o, _path + "/details", &m_extrasDB);
-	if (!m_db)
-		BOOST_THROW_EXCEPTION(DatabaseAlreadyOpen());
-	if (!m_extrasDB)
-		BOOST_THROW_EXCEPTION(DatabaseAlreadyOpen());
+	m_db = openDatabase(_path, "blocks");
+	m_extrasDB = openDatabase(_path, "details");
 
 	if (!details(m_genesisHash))
 	{
@@ -158,6 +158,25 @@ void BlockChain::open(std::string _path, bool _killExisting)
 
 	m_lastBlockHash = l.empty() ? m_genesisHash : *(h256*)l.data();
 
+	// Make sure the number index covers the canonical chain; a DB from before it existed gets indexed here, once.
+	noteCanon(m_lastBlockHash, number(m_lastBlockHash));
+	m_lastBlockNumber = number(m_lastBlockHash);
+	m_lastHashes = indexedLastHashes(m_lastBlockNumber);
+
+	// Likewise the bloom index: bring it up from wherever it was last left (which, should we have gone down in the
+	// middle of a reorganisation, may be off the canonical chain); for a DB from before it existed, that's genesis.
+	std::string b;
+	m_extrasDB->Get(m_readOptions, ldb::Slice("blooms"), &b);
+	h256 bloomed = b.size() == 32 ? *(h256*)b.data() : m_genesisHash;
+	if (!isKnown(bloomed))
+		bloomed = m_genesisHash;
+	if (bloomed != m_lastBlockHash)
+	{
+		h256 common;
+		treeRoute(bloomed, m_lastBlockHash, &common);
+		noteBlooms(number(common) + 1, number(m_lastBlockHash), number(bloomed));
+	}
+
 	cnote << "Opened blockchain DB. Latest: " << currentHash();
 }
 
@@ -167,7 +186,11 @@ void BlockChain::close()
 	delete m_extrasDB;
 	delete m_db;
 	m_lastBlockHash = m_genesisHash;
+	m_lastBlockNumber = 0;
+	m_lastHashes.reset();
 	m_details.clear();
+	m_blockHashes.clear();
+	m_blocksBlooms.clear();
 	m_cache.clear();
 }
 
@@ -190,19 +213,112 @@ inline string toString(h256s const& _bs)
 	return out.str();
 }
 
+string BlockChain::databaseStats() const
+{
+	return "blocks: " + eth::databaseStats(m_db) + "details: " + eth::databaseStats(m_extrasDB);
+}
+
 h256s BlockChain::sync(BlockQueue& _bq, OverlayDB const& _stateDB, unsigned _max)
 {
 	_bq.tick(*this);
 
 	vector<bytes> blocks;
 	_bq.drain(blocks);
+	if (blocks.empty())
+	{
+		_bq.doneDrain();
+		return h256s();
+	}
+
+	// Stage one: the checks needing nothing but the block itself (header, nonce, transactions & uncles roots and the
+	// transactions' senders), posted to the shared pool up to c_verifyAhead blocks ahead of execution. A job still
+	// queued when its block's turn comes is done here instead, so this never waits on a pool thread to become free.
+	// Jobs may outlast this call, hence the shared state.
+	struct Verified
+	{
+		BlockInfo info;
+		exception_ptr error;
+		bool claimed = false;
+		bool done = false;
+	};
+	struct Pipeline
+	{
+		vector<bytes> blocks;
+		vector<Verified> verified;
+		Mutex x;
+		condition_variable changed;
+		SyncStats stats;
+	};
+	auto p = make_shared<Pipeline>();
+	p->blocks = move(blocks);
+	p->verified.resize(p->blocks.size());
+
+	auto verify = [](shared_ptr<Pipeline> const& p, unsigned i)
+	{
+		{
+			Guard l(p->x);
+			if (p->verified[i].claimed)
+				return;
+			p->verified[i].claimed = true;
+		}
+		auto start = chrono::steady_clock::now();
+		BlockInfo info;
+		exception_ptr error;
+		try
+		{
+			info.populate(&p->blocks[i]);
+			info.verifyInternals(&p->blocks[i]);
+			for (auto const& tr: RLP(p->blocks[i])[1])
+				Transaction(tr.data()).sender();		// Cached process-wide, so execution needn't recover it again.
+		}
+		catch (...)
+		{
+			error = current_exception();
+		}
+		{
+			Guard l(p->x);
+			Verified& v = p->verified[i];
+			v.info = info;
+			v.error = error;
+			v.done = true;
+			p->stats.verified++;
+			p->stats.rejected += error ? 1 : 0;
+			p->stats.verifySeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		}
+		p->changed.notify_all();
+	};
+
+	ThreadPool& pool = ThreadPool::shared();
+	unsigned posted = 1;		// The first block is needed straight away, so isn't worth posting.
 
+	// Stage two: execution against the state, on this thread, strictly in order.
 	h256s ret;
-	for (auto const& block: blocks)
+	for (unsigned i = 0; i < p->blocks.size(); ++i)
 	{
+		if (pool.size())
+			for (; posted < min<size_t>(p->blocks.size(), i + 1 + c_verifyAhead); ++posted)
+			{
+				unsigned j = posted;
+				pool.post([=](){ verify(p, j); });
+			}
+		verify(p, i);
+
+		Verified v;
+		{
+			unique_lock<Mutex> l(p->x);
+			auto start = chrono::steady_clock::now();
+			p->changed.wait(l, [&](){ return p->verified[i].done; });
+			p->stats.stallSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			v = move(p->verified[i]);
+		}
+
+		bytes const& block = p->blocks[i];
+		auto start = chrono::steady_clock::now();
 		try
 		{
-			for (auto h: import(block, _stateDB))
+			if (v.error)
+				rethrow_exception(v.error);
+			for (auto h: import(block, v.info, _stateDB))
 				if (!_max--)
 					break;
 				else
@@ -220,8 +336,28 @@ h256s BlockChain::sync(BlockQueue& _bq, OverlayDB const& _stateDB, unsigned _max
 		}
 		catch (...)
 		{}
+
+		Guard l(p->x);
+		p->stats.imported++;
+		p->stats.importSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
 	}
 	_bq.doneDrain();
+
+	SyncStats stats;
+	{
+		Guard l(p->x);
+		stats = p->stats;
+	}
+	clog(BlockChainNote) << "Synced" << p->blocks.size() << "blocks:" << stats.verifySeconds << "s checking on" << (pool.size() + 1) << "threads," << stats.importSeconds << "s executing," << stats.stallSeconds << "s waiting for checks.";
+	{
+		Guard l(x_syncStats);
+		m_syncStats.verified += stats.verified;
+		m_syncStats.rejected += stats.rejected;
+		m_syncStats.verifySeconds += stats.verifySeconds;
+		m_syncStats.imported += stats.imported;
+		m_syncStats.importSeconds += stats.importSeconds;
+		m_syncStats.stallSeconds += stats.stallSeconds;
+	}
 	return ret;
 }
 
@@ -258,6 +394,12 @@ h256s BlockChain::import(bytes const& _block, OverlayDB const& _db)
 		throw;
 	}
 #endif
+	return import(_block, bi, _db);
+}
+
+h256s BlockChain::import(bytes const& _block, BlockInfo const& _bi, OverlayDB const& _db)
+{
+	BlockInfo const& bi = _bi;
 	auto newHash = BlockInfo::headerHash(_block);
 
 	// Check block doesn't already exist first!
@@ -358,9 +500,43 @@ h256s BlockChain::import(bytes const& _block, OverlayDB const& _db)
 	if (td > details(last).totalDifficulty)
 	{
 		ret = treeRoute(last, newHash);
+		unsigned newNumber = (unsigned)pd.number + 1;
+		unsigned lastNumber = number(last);
+		unsigned from = noteCanon(newHash, newNumber);
+
+		// Straight on top of the old head, the last hashes just shift along by one; after a reorganisation
+		// (or if we somehow don't have the old head's) they're looked up afresh from the index as now updated.
+		shared_ptr<LastHashes const> lh;
+		{
+			ReadGuard l(x_lastBlockHash);
+			if (m_lastHashes && bi.parentHash == m_lastBlockHash)
+			{
+				auto shifted = make_shared<LastHashes>(m_lastHashes->size());
+				(*shifted)[0] = newHash;
+				copy(m_lastHashes->begin(), m_lastHashes->end() - 1, shifted->begin() + 1);
+				lh = shifted;
+			}
+		}
+		if (!lh)
+			lh = indexedLastHashes(newNumber);
+
+		// The old canonical chain may have been longer; drop its now-stale tail from the number index.
+		for (unsigned n = newNumber + 1; n <= lastNumber; ++n)
+		{
+			{
+				WriteGuard l(x_blockHashes);
+				m_blockHashes.erase(h256(u256(n)));
+			}
+			m_extrasDB->Delete(m_writeOptions, toSlice(h256(u256(n)), 1));
+		}
+		// Bring the bloom index up to the new head before publishing it, so no reader sees a head it doesn't cover.
+		noteBlooms(from, newNumber, lastNumber);
+
 		{
 			WriteGuard l(x_lastBlockHash);
 			m_lastBlockHash = newHash;
+			m_lastBlockNumber = newNumber;
+			m_lastHashes = lh;
 		}
 		m_extrasDB->Put(m_writeOptions, ldb::Slice("best"), ldb::Slice((char const*)&newHash, 32));
 		clog(BlockChainNote) << "   Imported and best" << td << ". Has" << (details(bi.parentHash).children.size() - 1) << "siblings. Route:" << toString(ret);
@@ -508,11 +684,136 @@ bytes BlockChain::block(h256 _hash) const
 	return m_cache[_hash];
 }
 
+unsigned BlockChain::noteCanon(h256 _head, unsigned _n)
+{
+	for (h256 h = _head; _n && indexedHash(_n) != h; h = details(h).parent, --_n)
+	{
+		BlockHash bh(h);
+		{
+			WriteGuard l(x_blockHashes);
+			m_blockHashes[h256(u256(_n))] = bh;
+		}
+		m_extrasDB->Put(m_writeOptions, toSlice(h256(u256(_n)), 1), (ldb::Slice)dev::ref(bh.rlp()));
+	}
+	return _n + 1;
+}
+
+void BlockChain::noteBlooms(unsigned _from, unsigned _to, unsigned _oldTo)
+{
+	if (_from > _oldTo)
+	{
+		// Only new blocks on the end of the chain: just fold each into the entries covering it.
+		unsigned index[c_bloomIndexLevels];
+		LogBloom bloom[c_bloomIndexLevels];
+		for (unsigned l = 0; l < c_bloomIndexLevels; ++l)
+		{
+			index[l] = _from >> (c_bloomIndexBits * (l + 1));
+			bloom[l] = indexedBloom(l + 1, index[l]).value;
+		}
+		for (unsigned n = _from; n <= _to; ++n)
+		{
+			LogBloom b = blocksBloom(0, n);
+			for (unsigned l = 0; l < c_bloomIndexLevels; ++l)
+			{
+				unsigned i = n >> (c_bloomIndexBits * (l + 1));
+				if (i != index[l])
+				{
+					writeBloom(l + 1, index[l], bloom[l]);
+					index[l] = i;
+					bloom[l] = LogBloom();
+				}
+				bloom[l] |= b;
+			}
+		}
+		for (unsigned l = 0; l < c_bloomIndexLevels; ++l)
+			writeBloom(l + 1, index[l], bloom[l]);
+	}
+	else
+	{
+		// Blocks have been replaced, so their blooms can't just be taken out again: recompute every entry covering
+		// them from the level below, and drop those that now lie entirely beyond the end of the chain.
+		for (unsigned level = 1; level <= c_bloomIndexLevels; ++level)
+		{
+			unsigned shift = c_bloomIndexBits * level;
+			unsigned lastBelow = _to >> (shift - c_bloomIndexBits);
+			for (unsigned i = _from >> shift; i <= _to >> shift; ++i)
+			{
+				LogBloom b;
+				for (unsigned j = i << c_bloomIndexBits; j <= min(((i + 1) << c_bloomIndexBits) - 1, lastBelow); ++j)
+					b |= blocksBloom(level - 1, j);
+				writeBloom(level, i, b);
+			}
+			for (unsigned i = (_to >> shift) + 1; i <= _oldTo >> shift; ++i)
+			{
+				{
+					WriteGuard l(x_blocksBlooms);
+					m_blocksBlooms.erase(bloomKey(level, i));
+				}
+				m_extrasDB->Delete(m_writeOptions, toSlice(bloomKey(level, i), 5));
+			}
+		}
+	}
+
+	h256 to = _to ? indexedHash(_to) : m_genesisHash;
+	m_extrasDB->Put(m_writeOptions, ldb::Slice("blooms"), ldb::Slice((char const*)&to, 32));
+}
+
+void BlockChain::writeBloom(unsigned _level, unsigned _index, LogBloom const& _b)
+{
+	BlocksBloom bb(_b);
+	{
+		WriteGuard l(x_blocksBlooms);
+		m_blocksBlooms[bloomKey(_level, _index)] = bb;
+	}
+	m_extrasDB->Put(m_writeOptions, toSlice(bloomKey(_level, _index), 5), (ldb::Slice)dev::ref(bb.rlp()));
+}
+
+LogBloom BlockChain::blocksBloom(unsigned _level, unsigned _index) const
+{
+	if (_level)
+		return indexedBloom(_level, _index).value;
+
+	// Pick the bloom straight out of the stored header: no need to verify it again, and going around block() means
+	// a scan over many blocks doesn't leave them all in the block cache. The number index is used rather than
+	// numberHash(), since during import it runs ahead of the published head.
+	h256 h = _index ? indexedHash(_index) : m_genesisHash;
+	if (h == m_genesisHash)
+		return genesis().logBloom;
+	string d;
+	m_db->Get(m_readOptions, ldb::Slice((char const*)&h, 32), &d);
+	return d.empty() ? LogBloom() : RLP(d)[0][6].toHash<LogBloom>();
+}
+
 h256 BlockChain::numberHash(unsigned _n) const
 {
 	if (!_n)
 		return genesisHash();
-	h256 ret = currentHash();
-	for (; _n < details().number; ++_n, ret = details(ret).parent) {}
+	if (_n >= number())
+		return currentHash();
+	return indexedHash(_n);
+}
+
+shared_ptr<LastHashes const> BlockChain::lastHashes(unsigned _n) const
+{
+	{
+		ReadGuard l(x_lastBlockHash);
+		if (m_lastHashes && _n == m_lastBlockNumber)
+			return m_lastHashes;
+	}
+
+	auto ret = make_shared<LastHashes>(256);
+	for (unsigned i = 0; i < 256; ++i)
+		(*ret)[i] = numberHash(max(_n, i) - i);
+	return ret;
+}
+
+shared_ptr<LastHashes const> BlockChain::indexedLastHashes(unsigned _n) const
+{
+	auto ret = make_shared<LastHashes>(256);
+	for (unsigned i = 0; i < 256; ++i)
+	{
+		unsigned n = max(_n, i) - i;
+		(*ret)[i] = n ? indexedHash(n) : m_genesisHash;
+	}
 	return ret;
 }
@@ -31,6 +31,7 @@
 #include <libdevcore/Exceptions.h>
 #include <libethcore/CommonEth.h>
 #include <libethcore/BlockInfo.h>
+#include <libevm/ExtVMFace.h>
 #include <libdevcore/Guards.h>
 #include "BlockDetails.h"
 #include "Account.h"
@@ -61,6 +62,22 @@ std::map<Address, Account> const& genesisState();
 
 ldb::Slice toSlice(h256 _h, unsigned _sub = 0);
 
+/// Number of levels of the block bloom index above the blocks themselves.
+static const unsigned c_bloomIndexLevels = 3;
+/// Each level of the bloom index groups 2^c_bloomIndexBits items of the level below: 16, 256, 4096 blocks.
+static const unsigned c_bloomIndexBits = 4;
+
+/// Running totals for each stage of the import pipeline in BlockChain::sync().
+struct SyncStats
+{
+	unsigned verified = 0;			///< Blocks through the stateless checks (header, nonce, roots, senders).
+	unsigned rejected = 0;			///< Of those, how many failed them.
+	double verifySeconds = 0;		///< Time spent on those checks, summed over all the threads doing them.
+	unsigned imported = 0;			///< Blocks executed and written to the chain.
+	double importSeconds = 0;		///< Time spent executing and writing.
+	double stallSeconds = 0;		///< Time execution spent waiting for the checks to catch up.
+};
+
 /**
  * @brief Implements the blockchain database. All data this gives is disk-backed.
  * @threadsafe
@@ -79,9 +96,17 @@ public:
 	/// To be called from main loop every 100ms or so.
 	void process();
 
-	/// Sync the chain with any incoming blocks. All blocks should, if processed in order
+	/// Sync the chain with any incoming blocks. All blocks should, if processed in order.
+	/// The stateless checks of each block are done on the shared ThreadPool, a few blocks ahead of their execution,
+	/// which is done in order on the calling thread.
 	h256s sync(BlockQueue& _bq, OverlayDB const& _stateDB, unsigned _max);
 
+	/// @returns a report on the blocks and details databases: their approximate sizes and LevelDB's statistics.
+	std::string databaseStats() const;
+
+	/// @returns the running totals of sync()'s stages. Thread-safe.
+	SyncStats syncStats() const { Guard l(x_syncStats); return m_syncStats; }
+
 	/// Attempt to import the given block directly into the BlockChain and sync with the state DB.
 	/// @returns the block hashes of any blocks that came into/went out of the canonical block chain.
 	h256s attemptImport(bytes const& _block, OverlayDB const& _stateDB) noexcept;
@@ -90,6 +115,10 @@ public:
 	/// @returns the block hashes of any blocks that came into/went out of the canonical block chain.
 	h256s import(bytes const& _block, OverlayDB const& _stateDB);
 
+	/// As import(), but with @a _bi being the block's header, already populated and with the nonce and internals
+	/// (transactions & uncles roots) verified.
+	h256s import(bytes const& _block, BlockInfo const& _bi, OverlayDB const& _stateDB);
+
 	/// Returns true if the given block is known (though not necessarily a part of the canon chain).
 	bool isKnown(h256 _hash) const;
 
@@ -123,9 +152,19 @@ public:
 	/// Get the hash of the genesis block. Thread-safe.
 	h256 genesisHash() const { return m_genesisHash; }
 
-	/// Get the hash of a block of a given number. Slow; try not to use it too much.
+	/// Get the hash of the canonical block of a given number. Thread-safe.
+	/// @returns the current head's hash if @a _n is beyond the head.
 	h256 numberHash(unsigned _n) const;
 
+	/// Get the hashes of the 256 canonical blocks numbered @a _n, @a _n - 1, ... (genesis standing in for any before it),
+	/// as given to the VM for BLOCKHASH. Thread-safe. When @a _n is the head's number this is just the shared copy
+	/// kept up to date by import(); otherwise it's looked up in full.
+	std::shared_ptr<LastHashes const> lastHashes(unsigned _n) const;
+
+	/// Get the union of the log blooms of the canonical blocks numbered [_index, _index + 1) << (c_bloomIndexBits * _level).
+	/// Level 0 is the single block @a _index. If this doesn't contain a bloom, no block in the range does. Thread-safe.
+	LogBloom blocksBloom(unsigned _level, unsigned _index) const;
+
 	/// Get all blocks not allowed as uncles given a parent (i.e. featured as uncles/main in parent, parent + 1, ... parent + 5).
 	/// @returns set including the header-hash of every parent (including @a _parent) up to and including generation +5
 	/// togther with all their quoted uncles.
@@ -182,6 +221,26 @@ private:
 
 	void checkConsistency();
 
+	/// Get the hash of the canonical block of number @a _n straight from the number index; null if not indexed.
+	h256 indexedHash(unsigned _n) const { return queryExtras<BlockHash, 1>(h256(u256(_n)), m_blockHashes, x_blockHashes, NullBlockHash).value; }
+
+	/// Point the number index at the chain ending in @a _head (of number @a _n), walking back until
+	/// reaching a block that is already indexed (i.e. the common ancestor with the old canonical chain).
+	/// @returns the lowest number whose entry was (re)written, or _n + 1 if none needed to be.
+	unsigned noteCanon(h256 _head, unsigned _n);
+
+	/// Build the last hashes of the canonical block of number @a _n straight from the number index.
+	std::shared_ptr<LastHashes const> indexedLastHashes(unsigned _n) const;
+
+	/// Bring the bloom index up to date after the canonical blocks from @a _from to @a _to have been added or replaced.
+	/// The canonical chain previously ended at @a _oldTo; any of its blocks beyond @a _to are dropped from the index.
+	void noteBlooms(unsigned _from, unsigned _to, unsigned _oldTo);
+
+	/// Key of the bloom index entry of the given level and index.
+	static h256 bloomKey(unsigned _level, unsigned _index) { return h256((u256(_level) << 32) | _index); }
+	BlocksBloom indexedBloom(unsigned _level, unsigned _index) const { return queryExtras<BlocksBloom, 5>(bloomKey(_level, _index), m_blocksBlooms, x_blocksBlooms, NullBlocksBloom); }
+	void writeBloom(unsigned _level, unsigned _index, LogBloom const& _b);
+
 	/// The caches of the disk DB and their locks.
 	mutable boost::shared_mutex x_details;
 	mutable BlockDetailsHash m_details;
@@ -189,6 +248,10 @@ private:
 	mutable BlockLogBloomsHash m_logBlooms;
 	mutable boost::shared_mutex x_receipts;
 	mutable BlockReceiptsHash m_receipts;
+	mutable boost::shared_mutex x_blockHashes;
+	mutable BlockHashHash m_blockHashes;
+	mutable boost::shared_mutex x_blocksBlooms;
+	mutable BlocksBloomHash m_blocksBlooms;
 	mutable boost::shared_mutex x_cache;
 	mutable std::map<h256, bytes> m_cache;
 
@@ -196,9 +259,11 @@ private:
 	ldb::DB* m_db;
 	ldb::DB* m_extrasDB;
 
-	/// Hash of the last (valid) block on the longest chain.
+	/// Hash of the last (valid) block on the longest chain, together with its number and last hashes.
 	mutable boost::shared_mutex x_lastBlockHash;
 	h256 m_lastBlockHash;
+	unsigned m_lastBlockNumber = 0;
+	std::shared_ptr<LastHashes const> m_lastHashes;
 
 	/// Genesis block info.
 	h256 m_genesisHash;
@@ -207,6 +272,9 @@ private:
 	ldb::ReadOptions m_readOptions;
 	ldb::WriteOptions m_writeOptions;
 
+	mutable Mutex x_syncStats;
+	SyncStats m_syncStats;
+
 	friend std::ostream& operator<<(std::ostream& _out, BlockChain const& _bc);
 
 	/// Static genesis info and its lock.
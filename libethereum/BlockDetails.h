@@ -70,13 +70,37 @@ struct BlockReceipts
 	TransactionReceipts receipts;
 };
 
+struct BlockHash
+{
+	BlockHash() {}
+	BlockHash(h256 const& _h): value(_h) {}
+	BlockHash(RLP const& _r) { value = _r.toHash<h256>(); }
+	bytes rlp() const { RLPStream s; s << value; return s.out(); }
+
+	h256 value;
+};
+
+struct BlocksBloom
+{
+	BlocksBloom() {}
+	BlocksBloom(LogBloom const& _b): value(_b) {}
+	BlocksBloom(RLP const& _r) { value = _r.toHash<LogBloom>(); }
+	bytes rlp() const { RLPStream s; s << value; return s.out(); }
+
+	LogBloom value;
+};
+
 typedef std::map<h256, BlockDetails> BlockDetailsHash;
 typedef std::map<h256, BlockLogBlooms> BlockLogBloomsHash;
 typedef std::map<h256, BlockReceipts> BlockReceiptsHash;
+typedef std::map<h256, BlockHash> BlockHashHash;
+typedef std::map<h256, BlocksBloom> BlocksBloomHash;
 
 static const BlockDetails NullBlockDetails;
 static const BlockLogBlooms NullBlockLogBlooms;
 static const BlockReceipts NullBlockReceipts;
+static const BlockHash NullBlockHash;
+static const BlocksBloom NullBlocksBloom;
 
 }
 }
@@ -25,6 +25,7 @@
 #include <libethcore/Exceptions.h>
 #include <libethcore/BlockInfo.h>
 #include "BlockChain.h"
+#include "Transaction.h"
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
@@ -36,15 +37,19 @@ ImportResult BlockQueue::import(bytesConstRef _block, BlockChain const& _bc)
 
 	cblockq << "Queuing block" << h.abridged() << "for import...";
 
-	UpgradableGuard l(m_lock);
-
-	if (m_readySet.count(h) || m_drainingSet.count(h) || m_unknownSet.count(h))
 	{
-		// Already know about this one.
-		cblockq << "Already known.";
-		return ImportResult::AlreadyKnown;
+		ReadGuard l(m_lock);
+		if (m_readySet.count(h) || m_drainingSet.count(h) || m_unknownSet.count(h))
+		{
+			// Already know about this one.
+			cblockq << "Already known.";
+			return ImportResult::AlreadyKnown;
+		}
 	}
 
+	// The checks and sender recovery below need nothing from the queue, so are done without holding its lock; they
+	// can then run for several blocks at once and don't hold up drain().
+
 	// VERIFY: populates from the block and checks the block is internally coherent.
 	BlockInfo bi;
 
@@ -71,7 +76,17 @@ ImportResult BlockQueue::import(bytesConstRef _block, BlockChain const& _bc)
 		return ImportResult::AlreadyInChain;
 	}
 
-	UpgradeGuard ul(l);
+	// Recover the transactions' senders now, all cores at once, so it's done by the time the block gets executed.
+	recoverSenders(RLP(_block)[1]);
+
+	WriteGuard l(m_lock);
+
+	// Someone else may have queued it in the meantime.
+	if (m_readySet.count(h) || m_drainingSet.count(h) || m_unknownSet.count(h))
+	{
+		cblockq << "Already known.";
+		return ImportResult::AlreadyKnown;
+	}
 
 	// Check it's not in the future
 	if (bi.timestamp > (u256)time(0))
@@ -100,6 +115,8 @@ ImportResult BlockQueue::import(bytesConstRef _block, BlockChain const& _bc)
 			m_readySet.insert(h);
 
 			noteReadyWithoutWriteGuard(h);
+			if (m_onReady)
+				m_onReady();
 			return ImportResult::Success;
 		}
 	}
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <functional>
 #include <boost/thread.hpp>
 #include <libdevcore/Common.h>
 #include <libdevcore/Log.h>
@@ -80,6 +81,10 @@ public:
 	/// Return first block with an unknown parent.
 	h256 firstUnknown() const { ReadGuard l(m_lock); return m_unknownSet.size() ? *m_unknownSet.begin() : h256(); }
 
+	/// Set the function to be called whenever import() makes a block ready for chain insertion. It's called from the
+	/// importing thread, so should be quick; typically it just wakes up whatever does the inserting.
+	void onReady(std::function<void()> const& _f) { m_onReady = _f; }
+
 private:
 	void noteReadyWithoutWriteGuard(h256 _b);
 	void notePresentWithoutWriteGuard(bytesConstRef _block);
@@ -90,6 +95,7 @@ private:
 	std::vector<bytes> m_ready;								///< List of blocks, in correct order, ready for chain-import.
 	std::set<h256> m_unknownSet;							///< Set of all blocks whose parents are not ready/in-chain.
 	std::multimap<h256, std::pair<h256, bytes>> m_unknown;	///< For transactions that have an unknown parent; we map their parent hash to the block stuff, and insert once the block appears.
+	std::function<void()> m_onReady;						///< Called after a block has been made ready.
 	std::multimap<unsigned, bytes> m_future;				///< Set of blocks that are not yet valid.
 };
 
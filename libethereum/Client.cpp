@@ -34,6 +34,9 @@ using namespace dev;
 using namespace dev::eth;
 using namespace p2p;
 
+/// Longest the client's thread sits idle before checking up on things anyway; new work wakes it immediately.
+static const unsigned c_idleWaitMs = 1000;
+
 VersionChecker::VersionChecker(string const& _dbPath):
 	m_path(_dbPath.size() ? _dbPath : Defaults::dbPath())
 {
@@ -60,7 +63,7 @@ void VersionChecker::setOk()
 }
 
 Client::Client(p2p::Host* _extNet, std::string const& _dbPath, bool _forceClean, u256 _networkId):
-	Worker("eth"),
+	Worker("eth", c_idleWaitMs),
 	m_vc(_dbPath),
 	m_bc(_dbPath, !m_vc.ok() || _forceClean),
 	m_stateDB(State::openDB(_dbPath, !m_vc.ok() || _forceClean)),
@@ -69,6 +72,15 @@ Client::Client(p2p::Host* _extNet, std::string const& _dbPath, bool _forceClean,
 {
 	m_host = _extNet->registerCapability(new EthereumHost(m_bc, m_tq, m_bq, _networkId));
 
+	// Handle new transactions and blocks as soon as they arrive, rather than at the next poll.
+	m_tq.onReady([=]()
+	{
+		wake();
+		if (auto h = m_host.lock())
+			h->noteNewTransactions();
+	});
+	m_bq.onReady([=](){ wake(); });
+
 	setMiningThreads();
 	if (_dbPath.size())
 		Defaults::setDBPath(_dbPath);
@@ -110,6 +122,7 @@ void Client::doneWorking()
 	WriteGuard l(x_stateDB);
 	m_preMine.sync(m_bc);
 	m_postMine = m_preMine;
+	invalidateSnapshots();
 }
 
 void Client::flushTransactions()
@@ -139,6 +152,7 @@ void Client::killChain()
 
 	m_preMine = State(Address(), m_stateDB);
 	m_postMine = State(Address(), m_stateDB);
+	invalidateSnapshots();
 
 	if (auto h = m_host.lock())
 		h->reset();
@@ -163,6 +177,7 @@ void Client::clearPending()
 			appendFromNewPending(m_postMine.logBloom(i), changeds);
 		changeds.insert(PendingChangedFilter);
 		m_postMine = m_preMine;
+		invalidateSnapshots();
 	}
 
 	{
@@ -378,6 +393,40 @@ bytes Client::call(Address _dest, bytes const& _data, u256 _gas, u256 _value, u2
 	return bytes();
 }
 
+ExecutionResult Client::call(Address _from, u256 _value, Address _dest, bytes const& _data, u256 _gas, u256 _gasPrice)
+{
+	ExecutionResult ret;
+	try
+	{
+		// Work from the shared copy of the pending state, so neither its transactions nor x_stateDB are held up.
+		State temp = asOf(0).state().forExecution();
+
+		bigint gasCost = Interface::txGas(_data);
+		if (_gas < gasCost)
+			BOOST_THROW_EXCEPTION(OutOfGas() << RequirementError(gasCost, (bigint)_gas));
+		// Callers needn't have an account, since it's only a call; one that hasn't can still send nothing.
+		if (temp.addressInUse(_from))
+			temp.noteSending(_from);
+		if (_value)
+			temp.subBalance(_from, _value);
+
+		Executive e(temp, m_bc, 0);
+		if (!e.call(_dest, _dest, _from, _value, _gasPrice, &_data, _gas - (u256)gasCost, _from))
+			e.go();
+		ret.output = e.out().toBytes();
+		// Less the refund for cleared storage, as Executive::finalize() would give it.
+		u256 used = _gas - e.endGas();
+		ret.gasUsed = used - min(used / 2, e.refunds());
+		ret.excepted = e.excepted();
+	}
+	catch (...)
+	{
+		// TODO: Some sort of notification of failure.
+		ret.excepted = true;
+	}
+	return ret;
+}
+
 Address Client::transact(Secret _secret, u256 _endowment, bytes const& _init, u256 _gas, u256 _gasPrice)
 {
 	startWorking();
@@ -402,8 +451,6 @@ void Client::inject(bytesConstRef _rlp)
 
 void Client::doWork()
 {
-	// TODO: Use condition variable rather than polling.
-
 	cworkin << "WORK";
 	h256Set changeds;
 
@@ -460,6 +507,7 @@ void Client::doWork()
 			if (isMining())
 				cnote << "New block on chain: Restarting mining operation.";
 			m_postMine = m_preMine;
+			invalidateSnapshots();
 			rsm = true;
 			changeds.insert(PendingChangedFilter);
 			// TODO: Move transactions pending from m_postMine back to transaction queue.
@@ -473,6 +521,7 @@ void Client::doWork()
 			for (auto i: newPendingBlooms)
 				appendFromNewPending(i, changeds);
 			changeds.insert(PendingChangedFilter);
+			invalidateSnapshots();
 
 			if (isMining())
 				cnote << "Additional transaction ready: Restarting mining operation.";
@@ -486,11 +535,13 @@ void Client::doWork()
 			m.noteStateChange();
 	}
 
+	if (changeds.count(ChainChangedFilter))
+		if (auto h = m_host.lock())
+			h->noteNewBlocks();
+
 	cwork << "noteChanged" << changeds.size() << "items";
 	noteChanged(changeds);
 	cworkout << "WORK";
-
-	this_thread::sleep_for(chrono::milliseconds(100));
 }
 
 unsigned Client::numberOf(int _n) const
@@ -503,15 +554,26 @@ unsigned Client::numberOf(int _n) const
 		return m_bc.details().number + max(-(int)m_bc.details().number, 1 + _n);
 }
 
-State Client::asOf(int _h) const
+string Client::databaseStats() const
+{
+	ReadGuard l(x_stateDB);
+	return m_bc.databaseStats() + "state: " + eth::databaseStats(m_stateDB.db());
+}
+
+StateSnapshot Client::asOf(int _h) const
 {
 	ReadGuard l(x_stateDB);
-	if (_h == 0)
-		return m_postMine;
-	else if (_h == -1)
-		return m_preMine;
+	if (_h == 0 || _h == -1)
+	{
+		// The first reader since the last change publishes the copy; everyone after that just shares it.
+		Guard sl(x_snapshots);
+		auto& s = _h ? m_preMineSnapshot : m_postMineSnapshot;
+		if (!s)
+			s = make_shared<State>(_h ? m_preMine : m_postMine);
+		return StateSnapshot(s);
+	}
 	else
-		return State(m_stateDB, m_bc, m_bc.numberHash(numberOf(_h)));
+		return StateSnapshot(make_shared<State>(m_stateDB, m_bc, m_bc.numberHash(numberOf(_h))));
 }
 
 State Client::state(unsigned _txi, h256 _block) const
@@ -624,15 +686,30 @@ LogEntries Client::logs(LogFilter const& _f) const
 	unsigned skipped = 0;
 	unsigned falsePos = 0;
 #endif
-	auto h = m_bc.numberHash(begin);
 	unsigned n = begin;
-	for (; ret.size() != m && n != end; n--, h = m_bc.details(h).parent)
+	while (ret.size() != m && n != end)
 	{
+		// Skip whole runs of blocks whose aggregate bloom rules them out, largest run first.
+		unsigned level = c_bloomIndexLevels;
+		for (; level; --level)
+			if (!_f.matches(m_bc.blocksBloom(level, n >> (c_bloomIndexBits * level))))
+				break;
+		if (level)
+		{
+			unsigned first = (n >> (c_bloomIndexBits * level)) << (c_bloomIndexBits * level);
+#if ETH_DEBUG
+			skipped += n + 1 - max(first, end + 1);
+#endif
+			n = max(first, end + 1) - 1;
+			continue;
+		}
+
 #if ETH_DEBUG
 		int total = 0;
 #endif
+		auto h = m_bc.numberHash(n);
 		// check block bloom
-		if (_f.matches(m_bc.info(h).logBloom))
+		if (_f.matches(m_bc.blocksBloom(0, n)))
 			for (TransactionReceipt receipt: m_bc.receipts(h).receipts)
 			{
 				if (_f.matches(receipt.bloom()))
@@ -661,8 +738,7 @@ LogEntries Client::logs(LogFilter const& _f) const
 		else
 			skipped++;
 #endif
-		if (n == end)
-			break;
+		n--;
 	}
 #if ETH_DEBUG
 	cdebug << (begin - n) << "searched; " << skipped << "skipped; " << falsePos << "false +ves";
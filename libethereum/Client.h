@@ -37,6 +37,7 @@
 #include "BlockChain.h"
 #include "TransactionQueue.h"
 #include "State.h"
+#include "StateSnapshot.h"
 #include "CommonNet.h"
 #include "LogFilter.h"
 #include "Miner.h"
@@ -166,6 +167,10 @@ public:
 	/// Makes the given call. Nothing is recorded into the state.
 	virtual bytes call(Secret _secret, u256 _value, Address _dest, bytes const& _data = bytes(), u256 _gas = 10000, u256 _gasPrice = 10 * szabo);
 
+	/// Makes the given call as if sent by @a _from, without signing anything or paying for gas. Runs against a
+	/// throwaway copy of the pending state's accounts; nothing is recorded into the state or the DB.
+	virtual ExecutionResult call(Address _from, u256 _value, Address _dest, bytes const& _data, u256 _gas, u256 _gasPrice);
+
 	/// Makes the given call. Nothing is recorded into the state. This cheats by creating a null address and endowing it with a lot of ETH.
 	virtual bytes call(Address _dest, bytes const& _data = bytes(), u256 _gas = 125000, u256 _value = 0, u256 _gasPrice = 1 * ether);
 
@@ -231,6 +236,8 @@ public:
 	dev::eth::State postState() const { ReadGuard l(x_stateDB); return m_postMine; }
 	/// Get the object representing the current canonical blockchain.
 	BlockChain const& blockChain() const { return m_bc; }
+	/// @returns a report on each of our databases: their approximate sizes and LevelDB's statistics.
+	std::string databaseStats() const;
 
 	// Mining stuff:
 
@@ -248,7 +255,7 @@ public:
 	void setTurboMining(bool _enable = true) { m_turboMining = _enable; }
 
 	/// Set the coinbase address.
-	virtual void setAddress(Address _us) { m_preMine.setAddress(_us); }
+	virtual void setAddress(Address _us) { WriteGuard l(x_stateDB); m_preMine.setAddress(_us); invalidateSnapshots(); }
 	/// Get the coinbase address.
 	virtual Address address() const { return m_preMine.address(); }
 	/// Stops mining and sets the number of mining threads (0 for automatic).
@@ -287,6 +294,7 @@ private:
 
 	/// Overrides for being a mining host.
 	virtual void setupState(State& _s);
+	virtual void onComplete() { wake(); }
 	virtual bool turbo() const { return m_turboMining; }
 	virtual bool force() const { return m_forceMining; }
 
@@ -305,8 +313,12 @@ private:
 	/// Return the actual block number of the block with the given int-number (positive is the same, INT_MIN is genesis block, < 0 is negative age, thus -1 is most recently mined, 0 is pending.
 	unsigned numberOf(int _b) const;
 
-	State asOf(int _h) const;
-	State asOf(unsigned _h) const;
+	/// @returns a read-only view of the state as of block @a _h (0 for pending, -1 for the latest, as with numberOf()).
+	/// The pending and latest states are shared between views, so this copies nothing once they've been published.
+	StateSnapshot asOf(int _h) const;
+
+	/// Forget the published copies of m_preMine and m_postMine; call whenever either changes, under x_stateDB.
+	void invalidateSnapshots() { Guard l(x_snapshots); m_preMineSnapshot.reset(); m_postMineSnapshot.reset(); }
 
 	VersionChecker m_vc;					///< Dummy object to check & update the protocol version.
 	BlockChain m_bc;						///< Maintains block database.
@@ -318,6 +330,10 @@ private:
 	State m_preMine;						///< The present state of the client.
 	State m_postMine;						///< The state of the client which we're mining (i.e. it'll have all the rewards added).
 
+	mutable Mutex x_snapshots;				///< Lock on the two below; taken with x_stateDB held.
+	mutable std::shared_ptr<State const> m_preMineSnapshot;		///< Copy of m_preMine shared by asOf() views; made on demand.
+	mutable std::shared_ptr<State const> m_postMineSnapshot;	///< Copy of m_postMine shared by asOf() views; made on demand.
+
 	std::weak_ptr<EthereumHost> m_host;		///< Our Ethereum Host. Don't do anything if we can't lock.
 
 	std::vector<Miner> m_miners;
@@ -0,0 +1,101 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Database.cpp
+ * @date 2014
+ */
+
+#include "Database.h"
+
+#pragma warning(push)
+#pragma warning(disable: 4100 4267)
+#include <leveldb/db.h>
+#include <leveldb/cache.h>
+#include <leveldb/filter_policy.h>
+#pragma warning(pop)
+
+#include <map>
+#include <memory>
+#include <sstream>
+#include <libdevcore/Guards.h>
+#include <libethcore/Exceptions.h>
+#include "Defaults.h"
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+namespace ldb = leveldb;
+
+namespace
+{
+
+/// The caches and filter policies must outlive the databases using them, so we keep them for the life of the process;
+/// there's one cache for each database and size, and one filter policy for each size.
+Mutex x_tuning;
+map<pair<string, unsigned>, unique_ptr<ldb::Cache>> s_caches;
+map<unsigned, unique_ptr<ldb::FilterPolicy const>> s_filters;
+
+}
+
+ldb::DB* dev::eth::openDatabase(string const& _path, string const& _name)
+{
+	DatabaseProfile const& p = Defaults::databaseProfile();
+
+	ldb::Options o;
+	o.create_if_missing = true;
+	o.write_buffer_size = (size_t)p.writeBufferMB << 20;
+	o.max_open_files = p.maxOpenFiles;
+	o.compression = p.compression ? ldb::kSnappyCompression : ldb::kNoCompression;
+	{
+		Guard l(x_tuning);
+		if (p.cacheMB)
+		{
+			auto& c = s_caches[make_pair(_name, p.cacheMB)];
+			if (!c)
+				c.reset(ldb::NewLRUCache((size_t)p.cacheMB << 20));
+			o.block_cache = c.get();
+		}
+		if (p.bloomBits)
+		{
+			auto& f = s_filters[p.bloomBits];
+			if (!f)
+				f.reset(ldb::NewBloomFilterPolicy(p.bloomBits));
+			o.filter_policy = f.get();
+		}
+	}
+
+	ldb::DB* ret = nullptr;
+	ldb::DB::Open(o, _path + "/" + _name, &ret);
+	if (!ret)
+		BOOST_THROW_EXCEPTION(DatabaseAlreadyOpen());
+	return ret;
+}
+
+string dev::eth::databaseStats(ldb::DB* _db)
+{
+	ostringstream out;
+
+	// Keys are at most 33 bytes, so this spans everything.
+	string limit(34, '\xff');
+	ldb::Range all(ldb::Slice(""), ldb::Slice(limit));
+	uint64_t size = 0;
+	_db->GetApproximateSizes(&all, 1, &size);
+	out << "Approximate size: " << (size >> 20) << " MB" << endl;
+
+	string stats;
+	if (_db->GetProperty("leveldb.stats", &stats))
+		out << stats;
+	return out.str();
+}
@@ -0,0 +1,55 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Database.h
+ * @date 2014
+ *
+ * Opening and inspecting the LevelDB databases holding the chain and the state.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace leveldb { class DB; }
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * @brief How the LevelDB databases (blocks, details and state) are tuned. Each database gets a block cache of its
+ * own; the other settings apply to each alike. Set it with Defaults::setDatabaseProfile() before opening them.
+ */
+struct DatabaseProfile
+{
+	unsigned cacheMB = 32;			///< Size of each database's cache of uncompressed blocks; 0 for LevelDB's default.
+	unsigned bloomBits = 10;		///< Bits per key of the bloom filter that spares reads of absent keys; 0 for none.
+	unsigned writeBufferMB = 4;		///< Size of each database's in-memory write buffer.
+	bool compression = true;		///< Whether blocks are Snappy-compressed on disk.
+	unsigned maxOpenFiles = 500;	///< Most files each database keeps open at once.
+};
+
+/// Open (creating if need be) the database @a _name (e.g. "blocks") in the directory @a _path, tuned according to
+/// Defaults::databaseProfile(). Throws DatabaseAlreadyOpen if it can't be opened.
+leveldb::DB* openDatabase(std::string const& _path, std::string const& _name);
+
+/// @returns a human-readable report on @a _db: its approximate size on disk and LevelDB's own statistics.
+std::string databaseStats(leveldb::DB* _db);
+
+}
+}
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <libdevcore/Common.h>
+#include "Database.h"
 
 namespace dev
 {
@@ -39,9 +40,12 @@ public:
 	static Defaults* get() { if (!s_this) s_this = new Defaults; return s_this; }
 	static void setDBPath(std::string const& _dbPath) { get()->m_dbPath = _dbPath; }
 	static std::string const& dbPath() { return get()->m_dbPath; }
+	static void setDatabaseProfile(DatabaseProfile const& _p) { get()->m_databaseProfile = _p; }
+	static DatabaseProfile const& databaseProfile() { return get()->m_databaseProfile; }
 
 private:
 	std::string m_dbPath;
+	DatabaseProfile m_databaseProfile;
 
 	static Defaults* s_this;
 };
@@ -24,6 +24,9 @@ using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+/// Weight given to the newest sample of a sub's delivery rate.
+static const double c_rateSmoothing = 0.3;
+
 DownloadSub::DownloadSub(DownloadMan& _man): m_man(&_man)
 {
 	WriteGuard l(m_man->x_subs);
@@ -41,37 +44,158 @@ DownloadSub::~DownloadSub()
 
 h256Set DownloadSub::nextFetch(unsigned _n)
 {
-	Guard l(m_fetch);
-
-	if (m_remaining.size())
-		return m_remaining;
-
-	m_asked.clear();
-	m_indices.clear();
-	m_remaining.clear();
-
 	if (!m_man || m_man->chain().empty())
 		return h256Set();
 
-	m_asked = (~(m_man->taken() + m_attempted)).lowest(_n);
-	if (m_asked.empty())
-		m_asked = (~(m_man->taken(true) + m_attempted)).lowest(_n);
-	m_attempted += m_asked;
-	for (auto i: m_asked)
+	// taken() locks x_subs and then each sub's m_fetch, so must be called before we lock ours.
+	auto taken = m_man->taken();
+
+	Guard l(m_fetch);
+	auto asked = (~(taken + m_asked + m_attempted)).lowest(_n);
+	if (asked.empty())
+		asked = (~(m_man->taken(true) + m_asked + m_attempted)).lowest(_n);
+	m_asked += asked;
+	m_attempted += asked;
+
+	h256Set ret;
+	Request r;
+	r.sent = chrono::steady_clock::now();
 	{
-		auto x = m_man->m_chain[i];
-		m_remaining.insert(x);
-		m_indices[x] = i;
+		ReadGuard l(m_man->m_lock);
+		for (auto i: asked)
+		{
+			auto x = m_man->m_chain[i];
+			ret.insert(x);
+			r.hashes.push_back(x);
+			m_indices[x] = i;
+		}
 	}
-	return m_remaining;
+	m_remaining += ret;
+	if (!ret.empty())
+		m_requests.push_back(move(r));
+	return ret;
+}
+
+void DownloadSub::doneFetch()
+{
+	Guard l(m_fetch);
+	m_remaining.clear();
+	m_indices.clear();
+	m_asked.reset();
+	m_requests.clear();
+}
+
+bool DownloadSub::canFetch() const
+{
+	if (!m_man)
+		return false;
+	auto got = m_man->taken(true);
+	Guard l(m_fetch);
+	return !(~(got + m_attempted)).lowest(1).empty();
 }
 
 bool DownloadSub::noteBlock(h256 _hash)
 {
 	Guard l(m_fetch);
 	if (m_man && m_indices.count(_hash))
+	{
+		WriteGuard l(m_man->m_lock);
 		m_man->m_blocksGot += m_indices[_hash];
+	}
 	bool ret = !!m_remaining.count(_hash);
 	m_remaining.erase(_hash);
 	return ret;
 }
+
+void DownloadSub::noteResponse()
+{
+	Guard l(m_fetch);
+	if (m_requests.empty())
+		return;
+
+	auto now = chrono::steady_clock::now();
+	Request& r = m_requests.front();
+	if (!r.expired)
+	{
+		unsigned got = 0;
+		for (auto const& h: r.hashes)
+			if (m_remaining.count(h))
+				release(h, true);
+			else
+				++got;
+
+		// Answers queue up behind one another, so time each from when we were last answered if that's later.
+		double secs = chrono::duration<double>(now - max(r.sent, m_lastResponse)).count();
+		if (secs > 0)
+			m_rate = m_rate ? m_rate * (1 - c_rateSmoothing) + got / secs * c_rateSmoothing : got / secs;
+	}
+	m_lastResponse = now;
+	m_requests.pop_front();
+}
+
+unsigned DownloadSub::expire(chrono::steady_clock::time_point _deadline)
+{
+	Guard l(m_fetch);
+	unsigned ret = 0;
+	for (auto& r: m_requests)
+		if (!r.expired && r.sent < _deadline)
+		{
+			for (auto const& h: r.hashes)
+				if (m_remaining.count(h))
+				{
+					release(h, false);
+					++ret;
+				}
+			r.expired = true;
+			m_rate /= 2;
+		}
+	return ret;
+}
+
+void DownloadSub::release(h256 const& _hash, bool _attempted)
+{
+	auto it = m_indices.find(_hash);
+	if (it != m_indices.end())
+	{
+		m_asked -= it->second;
+		if (!_attempted)
+			m_attempted -= it->second;
+		m_indices.erase(it);
+	}
+	m_remaining.erase(_hash);
+}
+
+unsigned DownloadMan::expireRequests()
+{
+	auto deadline = chrono::steady_clock::now() - m_requestTimeout;
+	unsigned ret = 0;
+	ReadGuard l(x_subs);
+	for (auto i: m_subs)
+		ret += i->expire(deadline);
+	return ret;
+}
+
+bool DownloadMan::isFetching() const
+{
+	ReadGuard l(x_subs);
+	for (auto i: m_subs)
+		if (i->requestsInFlight())
+			return true;
+	return false;
+}
+
+unsigned DownloadMan::batchSize(DownloadSub const& _s, unsigned _max) const
+{
+	double best = 0;
+	{
+		ReadGuard l(x_subs);
+		for (auto i: m_subs)
+			best = max(best, i->rate());
+	}
+	double rate = _s.rate();
+
+	// Until we know how quickly a sub (or anyone) delivers, give it the benefit of the doubt; timeouts will tell.
+	if (!best || !rate)
+		return _max;
+	return max<unsigned>(max(1u, _max / 8), (unsigned)(_max * rate / best));
+}
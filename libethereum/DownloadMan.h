@@ -24,6 +24,8 @@
 #include <map>
 #include <vector>
 #include <set>
+#include <deque>
+#include <chrono>
 #include <libdevcore/Guards.h>
 #include <libdevcore/Worker.h>
 #include <libdevcore/RangeMask.h>
@@ -45,20 +47,42 @@ public:
 	DownloadSub(DownloadMan& _man);
 	~DownloadSub();
 
-	/// Finished last fetch - grab the next bunch of block hashes to download.
+	/// Grab the next bunch of (at most @a _n) block hashes to download, on top of any we're still waiting for. They
+	/// count as one more request in flight until noteResponse(). @returns empty if there's nothing more for us to fetch.
 	h256Set nextFetch(unsigned _n);
 
 	/// Note that we've received a particular block. @returns true if we had asked for it but haven't received it yet.
 	bool noteBlock(h256 _hash);
 
-	/// Nothing doing here.
-	void doneFetch() { resetFetch(); }
+	/// Note that the answer to our oldest request in flight is in; its blocks should already have been through
+	/// noteBlock(). Any it lacked go back to the other subs and we won't ask for them again.
+	void noteResponse();
+
+	/// Nothing doing here. What we've asked for and not got is kept as attempted, so that we're not asked for it again
+	/// before the download is reset.
+	void doneFetch();
+
+	/// @returns true if there are blocks still to fetch that we haven't already asked for without getting.
+	bool canFetch() const;
+
+	/// @returns the number of requests we've made that haven't been answered yet.
+	unsigned requestsInFlight() const { Guard l(m_fetch); return m_requests.size(); }
+
+	/// @returns how quickly, in blocks per second, our requests have been answered of late; zero if we don't know yet.
+	double rate() const { Guard l(m_fetch); return m_rate; }
 
 	bool askedContains(unsigned _i) const { Guard l(m_fetch); return m_asked.contains(_i); }
 	RangeMask<unsigned> const& asked() const { return m_asked; }
 	RangeMask<unsigned> const& attemped() const { return m_attempted; }
 
 private:
+	struct Request
+	{
+		h256s hashes;
+		std::chrono::steady_clock::time_point sent;
+		bool expired = false;			///< Its blocks have already been given back; we're just waiting for the answer.
+	};
+
 	void resetFetch()		// Called by DownloadMan when we need to reset the download.
 	{
 		Guard l(m_fetch);
@@ -66,8 +90,15 @@ private:
 		m_indices.clear();
 		m_asked.reset();
 		m_attempted.reset();
+		m_requests.clear();
 	}
 
+	/// Give back the blocks of any request sent before @a _deadline. Called by DownloadMan. @returns how many were given back.
+	unsigned expire(std::chrono::steady_clock::time_point _deadline);
+
+	/// Stop fetching @a _hash, letting other subs (and, unless @a _attempted, us) ask for it instead. Requires m_fetch.
+	void release(h256 const& _hash, bool _attempted);
+
 	DownloadMan* m_man = nullptr;
 
 	mutable Mutex m_fetch;
@@ -75,6 +106,9 @@ private:
 	std::map<h256, unsigned> m_indices;
 	RangeMask<unsigned> m_asked;
 	RangeMask<unsigned> m_attempted;
+	std::deque<Request> m_requests;							///< Requests in flight, oldest first, as answers arrive in order.
+	double m_rate = 0;										///< Smoothed blocks per second delivered.
+	std::chrono::steady_clock::time_point m_lastResponse;	///< When the last answer arrived.
 };
 
 class DownloadMan
@@ -115,15 +149,19 @@ public:
 		m_blocksGot.reset();
 	}
 
+	/// @returns the blocks we've got and, unless @a _desperate, those some sub has asked for. Locks x_subs and then
+	/// each sub's m_fetch, so mustn't be called with any m_fetch held.
 	RangeMask<unsigned> taken(bool _desperate = false) const
 	{
-		ReadGuard l(m_lock);
-		auto ret = m_blocksGot;
+		RangeMask<unsigned> ret = blocksGot();
 		if (!_desperate)
 		{
 			ReadGuard l(x_subs);
 			for (auto i: m_subs)
+			{
+				Guard l(i->m_fetch);
 				ret += i->m_asked;
+			}
 		}
 		return ret;
 	}
@@ -134,18 +172,41 @@ public:
 		return m_blocksGot.full();
 	}
 
+	/// Give back to the pool the blocks of any request that's gone unanswered for longer than the request timeout.
+	/// @returns the number of blocks given back.
+	unsigned expireRequests();
+
+	/// @returns true if any sub has a request in flight.
+	bool isFetching() const;
+
+	/// @returns how many blocks (at most @a _max) to ask for in one go from @a _s, in proportion to how quickly it
+	/// delivers compared with the quickest sub.
+	unsigned batchSize(DownloadSub const& _s, unsigned _max) const;
+
+	/// The number of requests each sub may have in flight at once.
+	unsigned requestsPerSub() const { return m_requestsPerSub; }
+	void setRequestsPerSub(unsigned _n) { m_requestsPerSub = std::max(1u, _n); }
+
+	/// How long a request may go unanswered before its blocks are given to other subs.
+	std::chrono::milliseconds requestTimeout() const { return m_requestTimeout; }
+	void setRequestTimeout(std::chrono::milliseconds _t) { m_requestTimeout = _t; }
+
 	h256s chain() const { ReadGuard l(m_lock); return m_chain; }
 	void foreachSub(std::function<void(DownloadSub const&)> const& _f) const { ReadGuard l(x_subs); for(auto i: m_subs) _f(*i); }
 	unsigned subCount() const { ReadGuard l(x_subs); return m_subs.size(); }
 	RangeMask<unsigned> blocksGot() const { ReadGuard l(m_lock); return m_blocksGot; }
 
 private:
+	// Locks are taken in the order x_subs, DownloadSub::m_fetch, m_lock; none is held while taking one before it.
 	mutable SharedMutex m_lock;
 	h256s m_chain;
 	RangeMask<unsigned> m_blocksGot;
 
 	mutable SharedMutex x_subs;
 	std::set<DownloadSub*> m_subs;
+
+	unsigned m_requestsPerSub = 2;
+	std::chrono::milliseconds m_requestTimeout = std::chrono::milliseconds(10000);
 };
 
 }
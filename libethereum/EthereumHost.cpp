@@ -38,9 +38,12 @@ using namespace dev;
 using namespace dev::eth;
 using namespace p2p;
 
+/// Longest we go without checking for transactions and blocks to send; noteNewTransactions()/noteNewBlocks() cut it short.
+static const unsigned c_idleWaitMs = 1000;
+
 EthereumHost::EthereumHost(BlockChain const& _ch, TransactionQueue& _tq, BlockQueue& _bq, u256 _networkId):
 	HostCapability<EthereumPeer>(),
-	Worker		("ethsync"),
+	Worker		("ethsync", c_idleWaitMs),
 	m_chain		(_ch),
 	m_tq		(_tq),
 	m_bq		(_bq),
@@ -63,8 +66,8 @@ bool EthereumHost::ensureInitialised()
 		m_latestBlockSent = m_chain.currentHash();
 		clog(NetNote) << "Initialising: latest=" << m_latestBlockSent.abridged();
 
-		for (auto const& i: m_tq.transactions())
-			m_transactionsSent.insert(i.first);
+		for (auto const& i: *m_tq.transactions())
+			m_transactionsSent.insert(i->hash);
 		return true;
 	}
 	return false;
@@ -152,6 +155,7 @@ void EthereumHost::reset()
 void EthereumHost::doWork()
 {
 	bool netChange = ensureInitialised();
+	maintainDownload();
 	auto h = m_chain.currentHash();
 	// If we've finished our initial sync (including getting all the blocks into the chain so as to reduce invalid transactions), start trading transactions & blocks
 	if (!isSyncing() && m_chain.isKnown(m_latestBlockSent))
@@ -164,20 +168,37 @@ void EthereumHost::doWork()
 	(void)netChange;
 }
 
+void EthereumHost::maintainDownload()
+{
+	if (unsigned n = m_man.expireRequests())
+		clog(NetNote) << n << "blocks requested but not received in time; asking other peers.";
+
+	// Peers only ask for more when answered, so wake those that have room to ask, or are idle with blocks left that
+	// they haven't already declined. Once there's nothing left to fetch, this lets the syncer finish up.
+	Guard l(x_interpret);
+	if (!isSyncing() || m_syncer->m_asking != Asking::Blocks)
+		return;
+	for (auto const& p: peers())
+		if (auto ep = p->cap<EthereumPeer>())
+			if ((ep->m_asking == Asking::Nothing && ep->m_sub.canFetch()) || (ep->m_asking == Asking::Blocks && ep->m_sub.requestsInFlight() < m_man.requestsPerSub()))
+				ep->transition(Asking::Blocks);
+}
+
 void EthereumHost::maintainTransactions()
 {
 	// Send any new transactions.
+	auto ts = m_tq.transactions();
 	for (auto const& p: peers())
 		if (auto ep = p->cap<EthereumPeer>())
 		{
 			bytes b;
 			unsigned n = 0;
-			for (auto const& i: m_tq.transactions())
-				if (ep->m_requireTransactions || (!m_transactionsSent.count(i.first) && !ep->m_knownTransactions.count(i.first)))
+			for (auto const& i: *ts)
+				if (ep->m_requireTransactions || (!m_transactionsSent.count(i->hash) && !ep->m_knownTransactions.count(i->hash)))
 				{
-					b += i.second;
+					b += i->rlp;
 					++n;
-					m_transactionsSent.insert(i.first);
+					m_transactionsSent.insert(i->hash);
 				}
 			ep->clearKnownTransactions();
 
@@ -71,10 +71,20 @@ public:
 	void reset();
 
 	DownloadMan const& downloadMan() const { return m_man; }
+
+	/// Set the number of block requests to keep in flight to each peer while downloading the chain.
+	void setBlockRequestsPerPeer(unsigned _n) { m_man.setRequestsPerSub(_n); }
+	/// Set how long a peer has to answer a block request before its blocks are asked of others.
+	void setBlockRequestTimeout(std::chrono::milliseconds _t) { m_man.setRequestTimeout(_t); }
 	bool isSyncing() const { return !!m_syncer; }
 
 	bool isBanned(p2p::NodeId _id) const { return !!m_banned.count(_id); }
 
+	/// Tell us there are new transactions in the queue, so we can pass them on to our peers without delay.
+	void noteNewTransactions() { wake(); }
+	/// Tell us there's a new best block, so we can pass it on to our peers without delay.
+	void noteNewBlocks() { wake(); }
+
 private:
 	/// Session is tell us that we may need (re-)syncing with the peer.
 	void noteNeedsSyncing(EthereumPeer* _who);
@@ -88,6 +98,9 @@ private:
 	void maintainTransactions();
 	void maintainBlocks(h256 _currentBlock);
 
+	/// Give timed-out block requests to other peers and top up each downloading peer's requests in flight.
+	void maintainDownload();
+
 	/// Get a bunch of needed blocks.
 	/// Removes them from our list of needed blocks.
 	/// @returns empty if there's no more blocks left to fetch, otherwise the blocks to fetch.
@@ -29,6 +29,7 @@
 #include "EthereumHost.h"
 #include "TransactionQueue.h"
 #include "BlockQueue.h"
+#include "Transaction.h"
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
@@ -156,15 +157,23 @@ void EthereumPeer::transition(Asking _a, bool _force)
 		{
 			// Looks like it's the best yet for total difficulty. Set to download.
 			setAsking(Asking::Blocks, isSyncing());		// will kick off other peers to help if available.
-			auto blocks = m_sub.nextFetch(c_maxBlocksAsk);
-			if (blocks.size())
+
+			// Keep as many requests in flight as we're allowed, each sized according to how quickly we've been delivering.
+			DownloadMan& man = host()->m_man;
+			while (m_sub.requestsInFlight() < man.requestsPerSub())
 			{
-				prep(s, GetBlocksPacket, blocks.size());
+				auto blocks = m_sub.nextFetch(man.batchSize(m_sub, c_maxBlocksAsk));
+				if (blocks.empty())
+					break;
+				RLPStream bs;
+				prep(bs, GetBlocksPacket, blocks.size());
 				for (auto const& i: blocks)
-					s << i;
-				sealAndSend(s);
+					bs << i;
+				sealAndSend(bs);
 			}
-			else
+
+			// Nothing more for us; unless others are still fetching (and may yet time out and give blocks back to us), we're done.
+			if (!m_sub.requestsInFlight() && (man.isComplete() || !man.isFetching()))
 				transition(Asking::Nothing);
 			return;
 		}
@@ -330,14 +339,22 @@ bool EthereumPeer::interpret(unsigned _id, RLP const& _r)
 	case GetTransactionsPacket: break;	// DEPRECATED.
 	case TransactionsPacket:
 	{
-		clogS(NetMessageSummary) << "Transactions (" << dec << (_r.itemCount() - 1) << "entries)";
-		addRating(_r.itemCount() - 1);
+		RLPIndex items(_r);
+		clogS(NetMessageSummary) << "Transactions (" << dec << (items.itemCount() - 1) << "entries)";
+		addRating(items.itemCount() - 1);
+
+		// Check all the signatures together, in parallel, before queuing them one by one.
+		vector<bytesConstRef> txs;
+		for (unsigned i = 1; i < items.itemCount(); ++i)
+			txs.push_back(items[i].data());
+		recoverSenders(txs);
+
 		Guard l(x_knownTransactions);
-		for (unsigned i = 1; i < _r.itemCount(); ++i)
+		for (unsigned i = 1; i < items.itemCount(); ++i)
 		{
-			auto h = sha3(_r[i].data());
+			auto h = sha3(items[i].data());
 			m_knownTransactions.insert(h);
-			if (!host()->m_tq.import(_r[i].data()))
+			if (!host()->m_tq.import(items[i].data()))
 				// if we already had the transaction, then don't bother sending it on.
 				host()->m_transactionsSent.insert(h);
 		}
@@ -361,21 +378,22 @@ bool EthereumPeer::interpret(unsigned _id, RLP const& _r)
 	}
 	case BlockHashesPacket:
 	{
-		clogS(NetMessageSummary) << "BlockHashes (" << dec << (_r.itemCount() - 1) << "entries)" << (_r.itemCount() - 1 ? "" : ": NoMoreHashes");
+		RLPIndex items(_r);
+		clogS(NetMessageSummary) << "BlockHashes (" << dec << (items.itemCount() - 1) << "entries)" << (items.itemCount() - 1 ? "" : ": NoMoreHashes");
 
 		if (m_asking != Asking::Hashes)
 		{
 			cwarn << "Peer giving us hashes when we didn't ask for them.";
 			break;
 		}
-		if (_r.itemCount() == 1)
+		if (items.itemCount() == 1)
 		{
 			transition(Asking::Blocks);
 			return true;
 		}
-		for (unsigned i = 1; i < _r.itemCount(); ++i)
+		for (unsigned i = 1; i < items.itemCount(); ++i)
 		{
-			auto h = _r[i].toHash<h256>();
+			auto h = items[i].toHash<h256>();
 			if (host()->m_chain.isKnown(h))
 			{
 				transition(Asking::Blocks);
@@ -390,13 +408,14 @@ bool EthereumPeer::interpret(unsigned _id, RLP const& _r)
 	}
 	case GetBlocksPacket:
 	{
-		clogS(NetMessageSummary) << "GetBlocks (" << dec << (_r.itemCount() - 1) << "entries)";
+		RLPIndex items(_r);
+		clogS(NetMessageSummary) << "GetBlocks (" << dec << (items.itemCount() - 1) << "entries)";
 		// return the requested blocks.
 		bytes rlp;
 		unsigned n = 0;
-		for (unsigned i = 1; i < _r.itemCount() && i <= c_maxBlocks; ++i)
+		for (unsigned i = 1; i < items.itemCount() && i <= c_maxBlocks; ++i)
 		{
-			auto b = host()->m_chain.block(_r[i].toHash<h256>());
+			auto b = host()->m_chain.block(items[i].toHash<h256>());
 			if (b.size())
 			{
 				rlp += b;
@@ -410,14 +429,16 @@ bool EthereumPeer::interpret(unsigned _id, RLP const& _r)
 	}
 	case BlocksPacket:
 	{
-		clogS(NetMessageSummary) << "Blocks (" << dec << (_r.itemCount() - 1) << "entries)" << (_r.itemCount() - 1 ? "" : ": NoMoreBlocks");
+		RLPIndex items(_r);
+		clogS(NetMessageSummary) << "Blocks (" << dec << (items.itemCount() - 1) << "entries)" << (items.itemCount() - 1 ? "" : ": NoMoreBlocks");
 
 		if (m_asking != Asking::Blocks)
 			clogS(NetWarn) << "Unexpected Blocks received!";
 
-		if (_r.itemCount() == 1)
+		if (items.itemCount() == 1)
 		{
 			// Got to this peer's latest block - just give up.
+			m_sub.noteResponse();
 			transition(Asking::Nothing);
 			break;
 		}
@@ -428,13 +449,13 @@ bool EthereumPeer::interpret(unsigned _id, RLP const& _r)
 		unsigned got = 0;
 		unsigned repeated = 0;
 
-		for (unsigned i = 1; i < _r.itemCount(); ++i)
+		for (unsigned i = 1; i < items.itemCount(); ++i)
 		{
-			auto h = BlockInfo::headerHash(_r[i].data());
+			auto h = BlockInfo::headerHash(items[i].data());
 			if (m_sub.noteBlock(h))
 			{
 				addRating(10);
-				switch (host()->m_bq.import(_r[i].data(), host()->m_chain))
+				switch (host()->m_bq.import(items[i].data(), host()->m_chain))
 				{
 				case ImportResult::Success:
 					success++;
@@ -465,6 +486,8 @@ bool EthereumPeer::interpret(unsigned _id, RLP const& _r)
 			}
 		}
 
+		m_sub.noteResponse();
+
 		clogS(NetMessageSummary) << dec << success << "imported OK," << unknown << "with unknown parents," << future << "with future timestamps," << got << " already known," << repeated << " repeats received.";
 
 		if (m_asking == Asking::Blocks)
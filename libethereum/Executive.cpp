@@ -35,7 +35,7 @@ using namespace dev::eth;
 
 Executive::Executive(State& _s, BlockChain const& _bc, unsigned _level):
 	m_s(_s),
-	m_lastHashes(_s.getLastHashes(_bc)),
+	m_lastHashes(*_s.getLastHashes(_bc)),
 	m_depth(_level)
 {}
 
@@ -127,7 +127,7 @@ bool Executive::call(Address _receiveAddress, Address _codeAddress, Address _sen
 	{
 		m_vm = VMFactory::create(_gas);
 		bytes const& c = m_s.code(_codeAddress);
-		m_ext = make_shared<ExtVM>(m_s, m_lastHashes, _receiveAddress, _senderAddress, _originAddress, _value, _gasPrice, _data, &c, m_depth);
+		m_ext = make_shared<ExtVM>(m_s, m_lastHashes, _receiveAddress, _senderAddress, _originAddress, _value, _gasPrice, _data, &c, m_depth, m_s.codeHash(_codeAddress));
 	}
 	else
 		m_endGas = _gas;
@@ -143,6 +143,7 @@ bool Executive::create(Address _sender, u256 _endowment, u256 _gasPrice, u256 _g
 	m_newAddress = right160(sha3(rlpList(_sender, m_s.transactionsFrom(_sender) - 1)));
 
 	// Set up new account...
+	m_s.journalEntry(m_newAddress);
 	m_s.m_cache[m_newAddress] = Account(m_s.balance(m_newAddress) + _endowment, Account::ContractConception);
 
 	// Execute _init.
@@ -220,6 +221,11 @@ bool Executive::go(OnOpFunc const& _onOp)
 	return true;
 }
 
+u256 Executive::refunds() const
+{
+	return m_ext ? m_ext->sub.refunds : 0;
+}
+
 void Executive::finalize(OnOpFunc const&)
 {
 	// SSTORE refunds...
@@ -100,6 +100,9 @@ public:
 	/// @returns true iff the operation ended with a VM exception.
 	bool excepted() const { return m_excepted; }
 
+	/// @returns the gas refunded so far for cleared storage, before finalize() caps it; zero if there's no VM execution.
+	u256 refunds() const;
+
 private:
 	State& m_s;							///< The state to which this operation/transaction is applied.
 	LastHashes m_lastHashes;
@@ -39,12 +39,16 @@ class ExtVM: public ExtVMFace
 {
 public:
 	/// Full constructor.
-	ExtVM(State& _s, LastHashes const& _lh, Address _myAddress, Address _caller, Address _origin, u256 _value, u256 _gasPrice, bytesConstRef _data, bytesConstRef _code, unsigned _depth = 0):
-		ExtVMFace(_myAddress, _caller, _origin, _value, _gasPrice, _data, _code.toBytes(), _s.m_previousBlock, _s.m_currentBlock, _lh, _depth), m_s(_s), m_origCache(_s.m_cache)
+	ExtVM(State& _s, LastHashes const& _lh, Address _myAddress, Address _caller, Address _origin, u256 _value, u256 _gasPrice, bytesConstRef _data, bytesConstRef _code, unsigned _depth = 0, h256 _codeHash = h256()):
+		ExtVMFace(_myAddress, _caller, _origin, _value, _gasPrice, _data, _code.toBytes(), _s.m_previousBlock, _s.m_currentBlock, _lh, _depth), m_s(_s), m_checkpoint(_s.checkpoint())
 	{
+		codeHash = _codeHash;
 		m_s.ensureCached(_myAddress, true, true);
 	}
 
+	/// Closes our checkpoint; our changes become part of the parent execution's.
+	~ExtVM() { m_s.closeCheckpoint(); }
+
 	/// Read storage location.
 	virtual u256 store(u256 _n) override final { return m_s.storage(myAddress, _n); }
 
@@ -79,13 +83,13 @@ public:
 
 	/// Revert any changes made (by any of the other calls).
 	/// @TODO check call site for the parent manifest being discarded.
-	virtual void revert() override final { m_s.m_cache = m_origCache; sub.clear(); }
+	virtual void revert() override final { m_s.rollback(m_checkpoint); sub.clear(); }
 
 	State& state() const { return m_s; }
 
 private:
 	State& m_s;										///< A reference to the base state.
-	std::map<Address, Account> m_origCache;			///< The cache of the address states (i.e. the externalities) as-was prior to the execution.
+	size_t m_checkpoint;							///< Where the state's journal of changes stood prior to the execution.
 };
 
 }
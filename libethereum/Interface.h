@@ -37,6 +37,14 @@ namespace dev
 namespace eth
 {
 
+/// The outcome of a message call made with Interface::call() from a bare address.
+struct ExecutionResult
+{
+	bytes output;				///< The data returned by the call.
+	u256 gasUsed;				///< Gas the call would have cost as a transaction: with the intrinsic cost, less any refund.
+	bool excepted = false;		///< True if the call ran out of gas or otherwise ended with a VM exception.
+};
+
 /**
  * @brief Main API hub for interfacing with Ethereum.
  */
@@ -67,6 +75,10 @@ public:
 	/// Makes the given call. Nothing is recorded into the state.
 	virtual bytes call(Secret _secret, u256 _value, Address _dest, bytes const& _data = bytes(), u256 _gas = 10000, u256 _gasPrice = 10 * szabo) = 0;
 
+	/// Makes the given call as if sent by @a _from, but without a signature and without paying for gas.
+	/// Nothing is recorded into the state.
+	virtual ExecutionResult call(Address _from, u256 _value, Address _dest, bytes const& _data, u256 _gas, u256 _gasPrice) = 0;
+
 	// [STATE-QUERY API]
 
 	int getDefault() const { return m_default; }
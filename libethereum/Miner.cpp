@@ -29,15 +29,17 @@ using namespace dev;
 using namespace dev::eth;
 
 Miner::Miner(MinerHost* _host, unsigned _id):
-	Worker("miner-" + toString(_id)),
+	Worker("miner-" + toString(_id), 100),
 	m_host(_host)
 {
+	m_mineState.setMiningPartition(_id);
 }
 
 void Miner::setup(MinerHost* _host, unsigned _id)
 {
 	m_host = _host;
 	setName("miner-" + toString(_id));
+	m_mineState.setMiningPartition(_id);
 }
 
 void Miner::doWork()
@@ -58,13 +60,17 @@ void Miner::doWork()
 				m_mineProgress.best = (double)-1;
 				m_mineProgress.hashes = 0;
 				m_mineProgress.ms = 0;
+				m_mineProgress.rate = 0;
+				m_mineProgress.threadRates = { 0 };
 			}
 		}
 
 		if (m_miningStatus == Mining)
 		{
 		// Mine for a while.
+			auto start = chrono::steady_clock::now();
 			MineInfo mineInfo = m_mineState.mine(100, m_host->turbo());
+			auto us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
 
 			{
 				Guard l(x_mineInfo);
@@ -73,6 +79,8 @@ void Miner::doWork()
 				m_mineProgress.requirement = mineInfo.requirement;
 				m_mineProgress.ms += 100;
 				m_mineProgress.hashes += mineInfo.hashes;
+				m_mineProgress.rate = us ? mineInfo.hashes * 1000000.0 / us : 0;
+				m_mineProgress.threadRates = { m_mineProgress.rate };
 				m_mineHistory.push_back(mineInfo);
 			}
 			if (mineInfo.completed)
@@ -85,8 +93,8 @@ void Miner::doWork()
 				m_host->onProgressed();
 		}
 	}
-	else
-	{
-		this_thread::sleep_for(chrono::milliseconds(100));
-	}
+
+	// Keep at it without idling while there's mining to be done.
+	if (m_miningStatus == Mining)
+		wake();
 }
@@ -40,12 +40,14 @@ namespace eth
  */
 struct MineProgress
 {
-	void combine(MineProgress const& _m) { requirement = std::max(requirement, _m.requirement); best = std::min(best, _m.best); current = std::max(current, _m.current); hashes += _m.hashes; ms = std::max(ms, _m.ms); }
+	void combine(MineProgress const& _m) { requirement = std::max(requirement, _m.requirement); best = std::min(best, _m.best); current = std::max(current, _m.current); hashes += _m.hashes; ms = std::max(ms, _m.ms); rate += _m.rate; threadRates.insert(threadRates.end(), _m.threadRates.begin(), _m.threadRates.end()); }
 	double requirement = 0;	///< The PoW requirement - as the second logarithm of the minimum acceptable hash.
 	double best = 1e99;		///< The PoW achievement - as the second logarithm of the minimum found hash.
 	double current = 0;		///< The most recent PoW achievement - as the second logarithm of the presently found hash.
 	unsigned hashes = 0;		///< Total number of hashes computed.
 	unsigned ms = 0;			///< Total number of milliseconds of mining thus far.
+	double rate = 0;			///< Hashes per second, summed over all mining threads.
+	std::vector<double> threadRates;	///< Hashes per second of each mining thread.
 };
 
 /**
@@ -79,7 +81,7 @@ class Miner: Worker
 {
 public:
 	/// Null constructor.
-	Miner(): m_host(nullptr) {}
+	Miner(): Miner(nullptr) {}
 
 	/// Constructor.
 	Miner(MinerHost* _host, unsigned _id = 0);
@@ -103,7 +105,7 @@ public:
 	void stop() { stopWorking(); }
 
 	/// Call to notify Miner of a state change.
-	void noteStateChange() { m_miningStatus = Preparing; }
+	void noteStateChange() { m_miningStatus = Preparing; wake(); }
 
 	/// @returns true iff the mining has been start()ed. It may still not be actually mining, depending on the host's turbo() & force().
 	bool isRunning() { return isWorking(); }
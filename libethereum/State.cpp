@@ -52,12 +52,7 @@ OverlayDB State::openDB(std::string _path, bool _killExisting)
 	if (_killExisting)
 		boost::filesystem::remove_all(_path + "/state");
 
-	ldb::Options o;
-	o.create_if_missing = true;
-	ldb::DB* db = nullptr;
-	ldb::DB::Open(o, _path + "/state", &db);
-	if (!db)
-		BOOST_THROW_EXCEPTION(DatabaseAlreadyOpen());
+	ldb::DB* db = openDatabase(_path, "state");
 
 	cnote << "Opened state DB.";
 	return OverlayDB(db);
@@ -123,6 +118,7 @@ State::State(State const& _s):
 	m_transactions(_s.m_transactions),
 	m_receipts(_s.m_receipts),
 	m_transactionSet(_s.m_transactionSet),
+	m_txQueueWatermark(_s.m_txQueueWatermark),
 	m_cache(_s.m_cache),
 	m_previousBlock(_s.m_previousBlock),
 	m_currentBlock(_s.m_currentBlock),
@@ -155,6 +151,7 @@ State& State::operator=(State const& _s)
 	m_transactions = _s.m_transactions;
 	m_receipts = _s.m_receipts;
 	m_transactionSet = _s.m_transactionSet;
+	m_txQueueWatermark = _s.m_txQueueWatermark;
 	m_cache = _s.m_cache;
 	m_previousBlock = _s.m_previousBlock;
 	m_currentBlock = _s.m_currentBlock;
@@ -220,9 +217,49 @@ StateDiff State::diff(State const& _c) const
 
 void State::ensureCached(Address _a, bool _requireCode, bool _forceCreate) const
 {
+	// A forced entry may be one that isn't in the trie, so it has to be undoable.
+	if (_forceCreate && !m_cache.count(_a))
+		journalEntry(_a);
 	ensureCached(m_cache, _a, _requireCode, _forceCreate);
 }
 
+void State::journalEntry(Address const& _a) const
+{
+	if (!m_checkpoints)
+		return;
+	auto it = m_cache.find(_a);
+	m_journal.push_back(CacheChange{CacheChange::Entry, _a, 0, 0, false, it == m_cache.end() ? nullptr : make_shared<Account>(it->second)});
+}
+
+void State::rollback(size_t _checkpoint)
+{
+	for (; m_journal.size() > _checkpoint; m_journal.pop_back())
+	{
+		CacheChange& c = m_journal.back();
+		switch (c.kind)
+		{
+		case CacheChange::Balance:
+			m_cache[c.address].balance() = c.value;
+			break;
+		case CacheChange::Nonce:
+			m_cache[c.address].nonce() = c.value;
+			break;
+		case CacheChange::Storage:
+			if (c.inOverlay)
+				m_cache[c.address].setStorage(c.key, c.value);
+			else
+				m_cache[c.address].unsetStorage(c.key);
+			break;
+		case CacheChange::Entry:
+			if (c.old)
+				m_cache[c.address] = move(*c.old);
+			else
+				m_cache.erase(c.address);
+			break;
+		}
+	}
+}
+
 void State::ensureCached(std::map<Address, Account>& _cache, Address _a, bool _requireCode, bool _forceCreate) const
 {
 	auto it = _cache.find(_a);
@@ -237,7 +274,7 @@ void State::ensureCached(std::map<Address, Account>& _cache, Address _a, bool _r
 		if (state.isNull())
 			s = Account(0, Account::NormalCreation);
 		else
-			s = Account(state[0].toInt<u256>(), state[1].toInt<u256>(), state[2].toHash<h256>(), state[3].toHash<h256>());
+			s = Account(state[0].toInt<u256>(), state[1].toInt<u256>(), state[2].toHash<h256>(), state[3].toHash<h256>(), Account::Unchanged);
 		bool ok;
 		tie(it, ok) = _cache.insert(make_pair(_a, s));
 	}
@@ -339,16 +376,21 @@ bool State::sync(BlockChain const& _bc, h256 _block, BlockInfo const& _bi)
 
 u256 State::enactOn(bytesConstRef _block, BlockInfo const& _bi, BlockChain const& _bc)
 {
-	// Check family:
-	BlockInfo biParent(_bc.block(_bi.parentHash));
+	// Check family; the ancestors are in the chain, so their nonces have been checked already.
+	BlockInfo biParent;
+	biParent.populate(_bc.block(_bi.parentHash), false);
 	_bi.verifyParent(biParent);
 	BlockInfo biGrandParent;
 	if (biParent.number)
-		biGrandParent.populate(_bc.block(biParent.parentHash));
+		biGrandParent.populate(_bc.block(biParent.parentHash), false);
 	sync(_bc, _bi.parentHash);
 	resetCurrent();
 	m_previousBlock = biParent;
-	return enact(_block, _bc);
+
+	if (m_currentBlock.parentHash != m_previousBlock.hash)
+		BOOST_THROW_EXCEPTION(InvalidParentHash());
+	m_currentBlock = _bi;
+	return playback(_block, _bc);
 }
 
 map<Address, u256> State::addresses() const
@@ -368,6 +410,7 @@ void State::resetCurrent()
 	m_transactions.clear();
 	m_receipts.clear();
 	m_transactionSet.clear();
+	m_txQueueWatermark = 0;
 	m_cache.clear();
 	m_currentBlock = BlockInfo();
 	m_currentBlock.coinbaseAddress = m_ourAddress;
@@ -389,26 +432,12 @@ bool State::cull(TransactionQueue& _tq) const
 {
 	bool ret = false;
 	auto ts = _tq.transactions();
-	for (auto const& i: ts)
-	{
-		if (!m_transactionSet.count(i.first))
+	for (auto const& i: *ts)
+		if (!m_transactionSet.count(i->hash) && i->nonce <= transactionsFrom(i->sender))
 		{
-			try
-			{
-				Transaction t(i.second);
-				if (t.nonce() <= transactionsFrom(t.sender()))
-				{
-					_tq.drop(i.first);
-					ret = true;
-				}
-			}
-			catch (...)
-			{
-				_tq.drop(i.first);
-				ret = true;
-			}
+			_tq.drop(i->hash);
+			ret = true;
 		}
-	}
 	return ret;
 }
 
@@ -416,25 +445,45 @@ h512s State::sync(BlockChain const& _bc, TransactionQueue& _tq, bool* o_transact
 {
 	// TRANSACTIONS
 	h512s ret;
-	auto ts = _tq.transactions();
+	shared_ptr<LastHashes const> lh;
 
-	auto lh = getLastHashes(_bc);
-
-	for (int goodTxs = 1; goodTxs;)
+	// Anything that became current before our watermark is either in already or has since been dropped or set
+	// aside. Setting aside is undone by noteGood(), which makes them current again, so keep going until there's
+	// nothing new.
+	for (QueuedTransactions ts; !(ts = _tq.transactionsSince(m_txQueueWatermark)).empty();)
 	{
-		goodTxs = 0;
+		if (!lh)
+			lh = getLastHashes(_bc);
+
+		// These come best gas price first, but with each sender's in nonce order.
 		for (auto const& i: ts)
-			if (!m_transactionSet.count(i.first))
+			if (!m_transactionSet.count(i->hash))
 			{
+				uncommitToMine();
+
+				// Check the nonce against the sender's before bothering to execute it.
+				u256 required = transactionsFrom(i->sender);
+				if (i->nonce < required)
+				{
+					// too old
+					_tq.drop(i->hash);
+					if (o_transactionQueueChanged)
+						*o_transactionQueueChanged = true;
+					continue;
+				}
+				if (i->nonce > required)
+				{
+					_tq.setFuture(i->hash);
+					continue;
+				}
+
 				// don't have it yet! Execute it now.
 				try
 				{
-					uncommitToMine();
 //					boost::timer t;
-					execute(lh, i.second);
+					execute(*lh, i->rlp);
 					ret.push_back(m_receipts.back().bloom());
-					_tq.noteGood(i);
-					++goodTxs;
+					_tq.noteGood(i->sender);
 //					cnote << "TX took:" << t.elapsed() * 1000;
 				}
 				catch (InvalidNonce const& in)
@@ -442,17 +491,17 @@ h512s State::sync(BlockChain const& _bc, TransactionQueue& _tq, bool* o_transact
 					if (in.required > in.candidate)
 					{
 						// too old
-						_tq.drop(i.first);
+						_tq.drop(i->hash);
 						if (o_transactionQueueChanged)
 							*o_transactionQueueChanged = true;
 					}
 					else
-						_tq.setFuture(i);
+						_tq.setFuture(i->hash);
 				}
 				catch (Exception const& _e)
 				{
 					// Something else went wrong - drop it.
-					_tq.drop(i.first);
+					_tq.drop(i->hash);
 					if (o_transactionQueueChanged)
 						*o_transactionQueueChanged = true;
 					cwarn << "Sync went wrong\n" << diagnostic_information(_e);
@@ -460,7 +509,7 @@ h512s State::sync(BlockChain const& _bc, TransactionQueue& _tq, bool* o_transact
 				catch (std::exception const&)
 				{
 					// Something else went wrong - drop it.
-					_tq.drop(i.first);
+					_tq.drop(i->hash);
 					if (o_transactionQueueChanged)
 						*o_transactionQueueChanged = true;
 				}
@@ -487,18 +536,22 @@ u256 State::enact(bytesConstRef _block, BlockChain const& _bc, bool _checkNonce)
 	m_currentBlock.populate(_block, _checkNonce);
 	m_currentBlock.verifyInternals(_block);
 
+	return playback(_block, _bc);
+}
+
+u256 State::playback(bytesConstRef _block, BlockChain const& _bc)
+{
 //	cnote << "playback begins:" << m_state.root();
 //	cnote << m_state;
 
-	MemoryDB tm;
-	GenericTrieDB<MemoryDB> transactionsTrie(&tm);
-	transactionsTrie.init();
-
 	MemoryDB rm;
 	GenericTrieDB<MemoryDB> receiptsTrie(&rm);
 	receiptsTrie.init();
 
-	LastHashes lh = getLastHashes(_bc);
+	auto lh = getLastHashes(_bc);
+
+	// Get all the senders up front, in parallel; usually the BlockQueue has already done it and this is just a lookup.
+	recoverSenders(RLP(_block)[1]);
 
 	// All ok with the block generally. Play back the transactions now...
 	unsigned i = 0;
@@ -507,8 +560,7 @@ u256 State::enact(bytesConstRef _block, BlockChain const& _bc, bool _checkNonce)
 		RLPStream k;
 		k << i;
 
-		transactionsTrie.insert(&k.out(), tr.data());
-		execute(lh, tr.data());
+		execute(*lh, tr.data());
 
 		RLPStream receiptrlp;
 		m_receipts.back().streamRLP(receiptrlp);
@@ -516,12 +568,6 @@ u256 State::enact(bytesConstRef _block, BlockChain const& _bc, bool _checkNonce)
 		++i;
 	}
 
-	if (transactionsTrie.root() != m_currentBlock.transactionsRoot)
-	{
-		cwarn << "Bad transactions state root!";
-		BOOST_THROW_EXCEPTION(InvalidTransactionsStateRoot());
-	}
-
 	if (receiptsTrie.root() != m_currentBlock.receiptsRoot)
 	{
 		cwarn << "Bad receipts state root.";
@@ -838,10 +884,15 @@ void State::noteSending(Address _id)
 	{
 		cwarn << "Sending from non-existant account. How did it pay!?!";
 		// this is impossible. but we'll continue regardless...
+		journalEntry(_id);
 		m_cache[_id] = Account(1, 0);
 	}
 	else
+	{
+		if (m_checkpoints)
+			m_journal.push_back(CacheChange{CacheChange::Nonce, _id, 0, it->second.nonce(), false, nullptr});
 		it->second.incNonce();
+	}
 }
 
 void State::addBalance(Address _id, u256 _amount)
@@ -849,9 +900,16 @@ void State::addBalance(Address _id, u256 _amount)
 	ensureCached(_id, false, false);
 	auto it = m_cache.find(_id);
 	if (it == m_cache.end())
+	{
+		journalEntry(_id);
 		m_cache[_id] = Account(_amount, Account::NormalCreation);
+	}
 	else
+	{
+		if (m_checkpoints)
+			m_journal.push_back(CacheChange{CacheChange::Balance, _id, 0, it->second.balance(), false, nullptr});
 		it->second.addBalance(_amount);
+	}
 }
 
 void State::subBalance(Address _id, bigint _amount)
@@ -861,7 +919,11 @@ void State::subBalance(Address _id, bigint _amount)
 	if (it == m_cache.end() || (bigint)it->second.balance() < _amount)
 		BOOST_THROW_EXCEPTION(NotEnoughCash());
 	else
+	{
+		if (m_checkpoints)
+			m_journal.push_back(CacheChange{CacheChange::Balance, _id, 0, it->second.balance(), false, nullptr});
 		it->second.addBalance(-_amount);
+	}
 }
 
 Address State::newContract(u256 _balance, bytes const& _code)
@@ -875,6 +937,7 @@ Address State::newContract(u256 _balance, bytes const& _code)
 		auto it = m_cache.find(ret);
 		if (it == m_cache.end())
 		{
+			journalEntry(ret);
 			m_cache[ret] = Account(0, _balance, EmptyTrie, h);
 			return ret;
 		}
@@ -909,10 +972,27 @@ u256 State::storage(Address _id, u256 _memory) const
 	TrieDB<h256, OverlayDB> memdb(const_cast<OverlayDB*>(&m_db), it->second.baseRoot());			// promise we won't change the overlay! :)
 	string payload = memdb.at(_memory);
 	u256 ret = payload.size() ? RLP(payload).toInt<u256>() : 0;
-	it->second.setStorage(_memory, ret);
+	it->second.noteStorage(_memory, ret);
 	return ret;
 }
 
+void State::setStorage(Address _contract, u256 _location, u256 _value)
+{
+	auto it = m_cache.find(_contract);
+	if (it == m_cache.end())
+	{
+		journalEntry(_contract);
+		it = m_cache.insert(make_pair(_contract, Account())).first;
+	}
+	else if (m_checkpoints)
+	{
+		auto sit = it->second.storageOverlay().find(_location);
+		bool inOverlay = sit != it->second.storageOverlay().end();
+		m_journal.push_back(CacheChange{CacheChange::Storage, _contract, _location, inOverlay ? sit->second : 0, inOverlay, nullptr});
+	}
+	it->second.setStorage(_location, _value);
+}
+
 map<u256, u256> State::storage(Address _id) const
 {
 	map<u256, u256> ret;
@@ -958,6 +1038,15 @@ bytes const& State::code(Address _contract) const
 	return m_cache[_contract].code();
 }
 
+h256 State::codeHash(Address _contract) const
+{
+	if (!addressHasCode(_contract))
+		return EmptySHA3;
+	ensureCached(_contract, false, false);
+	Account const& a = m_cache[_contract];
+	return a.isFreshCode() ? h256() : a.codeHash();
+}
+
 bool State::isTrieGood(bool _enforceRefs, bool _requireNoLeftOvers) const
 {
 	for (int e = 0; e < (_enforceRefs ? 2 : 1); ++e)
@@ -993,30 +1082,23 @@ bool State::isTrieGood(bool _enforceRefs, bool _requireNoLeftOvers) const
 	return true;
 }
 
-LastHashes State::getLastHashes(BlockChain const& _bc) const
+shared_ptr<LastHashes const> State::getLastHashes(BlockChain const& _bc) const
 {
-	LastHashes ret;
-	ret.resize(256);
 	if (c_protocolVersion > 49)
-	{
-		unsigned n = (unsigned)m_previousBlock.number;
-		for (unsigned i = 0; i < 256; ++i)
-			ret[i] = _bc.numberHash(std::max<unsigned>(n, i) - i);
-	}
-	return ret;
+		return _bc.lastHashes((unsigned)m_previousBlock.number);
+	static const shared_ptr<LastHashes const> s_none = make_shared<LastHashes>(256);
+	return s_none;
 }
 
 // TODO: maintain node overlay revisions for stateroots -> each commit gives a stateroot + OverlayDB; allow overlay copying for rewind operations.
 u256 State::execute(LastHashes const& _lh, bytesConstRef _rlp, bytes* o_output, bool _commit)
 {
-#ifndef ETH_RELEASE
+	// Only the paranoid need the state as it was; otherwise the commit after execution writes just the accounts the
+	// transaction dirtied (and any left over from before), which gives the intermediate root for the receipt.
+#if ETH_PARANOIA
 	commit();	// get an updated hash
-#endif
-
 	paranoia("start of execution.", true);
-
 	State old(*this);
-#if ETH_PARANOIA
 	auto h = rootHash();
 #endif
 
@@ -1096,6 +1178,17 @@ State State::fromPending(unsigned _i) const
 	return ret;
 }
 
+State State::forExecution() const
+{
+	State ret(m_ourAddress, m_db, BaseState::Empty);
+	ret.m_state.setRoot(m_state.root());
+	ret.m_cache = m_cache;
+	ret.m_previousBlock = m_previousBlock;
+	ret.m_currentBlock = m_currentBlock;
+	ret.m_blockReward = m_blockReward;
+	return ret;
+}
+
 void State::applyRewards(Addresses const& _uncleAddresses)
 {
 	u256 r = m_blockReward;
@@ -65,6 +65,7 @@ class State
 	friend class ExtVM;
 	friend class dev::test::ImportTest;
 	friend class Executive;
+	friend class StateSnapshot;
 
 public:
 	/// Construct state object.
@@ -119,6 +120,10 @@ public:
 	/// @returns Information on the mining.
 	MineInfo mine(unsigned _msTimeout = 1000, bool _turbo = false);
 
+	/// Only try nonces whose top 32 bits are @a _partition; give each of several States mining the same block a
+	/// different one so that they don't duplicate work. Kept across assignment, as is all the mining state.
+	void setMiningPartition(unsigned _partition) { m_pow.setPartition(_partition); }
+
 	/** Commit to DB and build the final block if the previous call to mine()'s result is completion.
 	 * Typically looks like:
 	 * @code
@@ -140,6 +145,8 @@ public:
 
 	// TODO: Cleaner interface.
 	/// Sync our transactions, killing those from the queue that we have and assimilating those that we don't.
+	/// Only transactions that have become current in the queue since the last sync are looked at; resetCurrent()
+	/// makes the next sync go through the whole queue again.
 	/// @returns a list of bloom filters one for each transaction placed from the queue into the state.
 	/// @a o_transactionQueueChanged boolean pointer, the value of which will be set to true if the transaction queue
 	/// changed and the pointer is non-null
@@ -147,12 +154,14 @@ public:
 	/// Like sync but only operate on _tq, killing the invalid/old ones.
 	bool cull(TransactionQueue& _tq) const;
 
-	LastHashes getLastHashes(BlockChain const& _bc) const;
+	/// @returns the hashes of the 256 blocks before our current block, as given to the VM. Shared with @a _bc
+	/// (and so free to get) when our previous block is its head.
+	std::shared_ptr<LastHashes const> getLastHashes(BlockChain const& _bc) const;
 
 	/// Execute a given transaction.
 	/// This will append @a _t to the transaction list and change the state accordingly.
-	u256 execute(BlockChain const& _bc, bytes const& _rlp, bytes* o_output = nullptr, bool _commit = true) { return execute(getLastHashes(_bc), &_rlp, o_output, _commit); }
-	u256 execute(BlockChain const& _bc, bytesConstRef _rlp, bytes* o_output = nullptr, bool _commit = true) { return execute(getLastHashes(_bc), _rlp, o_output, _commit); }
+	u256 execute(BlockChain const& _bc, bytes const& _rlp, bytes* o_output = nullptr, bool _commit = true) { return execute(*getLastHashes(_bc), &_rlp, o_output, _commit); }
+	u256 execute(BlockChain const& _bc, bytesConstRef _rlp, bytes* o_output = nullptr, bool _commit = true) { return execute(*getLastHashes(_bc), _rlp, o_output, _commit); }
 	u256 execute(LastHashes const& _lh, bytes const& _rlp, bytes* o_output = nullptr, bool _commit = true) { return execute(_lh, &_rlp, o_output, _commit); }
 	u256 execute(LastHashes const& _lh, bytesConstRef _rlp, bytes* o_output = nullptr, bool _commit = true);
 
@@ -187,7 +196,7 @@ public:
 	u256 storage(Address _contract, u256 _memory) const;
 
 	/// Set the value of a storage position of an account.
-	void setStorage(Address _contract, u256 _location, u256 _value) { m_cache[_contract].setStorage(_location, _value); }
+	void setStorage(Address _contract, u256 _location, u256 _value);
 
 	/// Create a new contract.
 	Address newContract(u256 _balance, bytes const& _code);
@@ -201,6 +210,11 @@ public:
 	/// @returns bytes() if no account exists at that address.
 	bytes const& code(Address _contract) const;
 
+	/// Get the hash of the code of an account.
+	/// @returns EmptySHA3 if no account exists at that address or if there is no code associated with the address,
+	/// or the null hash if the account's code is still being determined.
+	h256 codeHash(Address _contract) const;
+
 	/// Note that the given address is sending a transaction and thus increment the associated ticker.
 	void noteSending(Address _id);
 
@@ -231,6 +245,10 @@ public:
 	/// If (_i == pending().size()) returns the final state of the block, prior to rewards.
 	State fromPending(unsigned _i) const;
 
+	/// @returns a State to execute speculatively on top of this one (e.g. for a call that's to be thrown away):
+	/// it has our accounts and block headers but none of the pending transactions or their receipts.
+	State forExecution() const;
+
 	/// @returns the StateDiff caused by the pending transaction of index @a _i.
 	StateDiff pendingDiff(unsigned _i) const { return fromPending(_i).diff(fromPending(_i + 1)); }
 
@@ -244,7 +262,8 @@ public:
 	/// Sync with the block chain, but rather than synching to the latest block, instead sync to the given block.
 	bool sync(BlockChain const& _bc, h256 _blockHash, BlockInfo const& _bi = BlockInfo());
 
-	/// Execute all transactions within a given block.
+	/// Execute all transactions within a given block. @a _bi must be its header, already populated from the block and
+	/// with the nonce and internals (transactions & uncles roots) verified, as BlockChain::import() does beforehand.
 	/// @returns the additional total difficulty.
 	u256 enactOn(bytesConstRef _block, BlockInfo const& _bi, BlockChain const& _bc);
 
@@ -260,6 +279,38 @@ public:
 	void resetCurrent();
 
 private:
+	/// A single undoable change to m_cache, as recorded in m_journal.
+	struct CacheChange
+	{
+		enum Kind
+		{
+			Balance,	///< The balance of address was altered; value holds the old one.
+			Nonce,		///< The nonce of address was altered; value holds the old one.
+			Storage,	///< Storage slot key of address was altered; value holds the old one if inOverlay.
+			Entry		///< The whole entry for address was replaced or inserted; old holds what was there, if anything.
+		};
+
+		Kind kind;
+		Address address;
+		u256 key;
+		u256 value;
+		bool inOverlay;
+		std::shared_ptr<Account> old;
+	};
+
+	/// Open a checkpoint in the journal of changes to the cache, which is kept only while there's one open.
+	/// @returns the checkpoint's position in the journal, for rollback().
+	size_t checkpoint() { ++m_checkpoints; return m_journal.size(); }
+
+	/// Undo every change made to the cache since @a _checkpoint was opened. The checkpoint stays open.
+	void rollback(size_t _checkpoint);
+
+	/// Close the innermost checkpoint. Its changes may still be undone by rolling back any enclosing one.
+	void closeCheckpoint() { if (!--m_checkpoints) m_journal.clear(); }
+
+	/// Record in the journal the entry for @a _a as it now is (or its absence), if a checkpoint is open.
+	void journalEntry(Address const& _a) const;
+
 	/// Undo the changes to the state for committing to mine.
 	void uncommitToMine();
 
@@ -276,6 +327,10 @@ private:
 	/// Throws on failure.
 	u256 enact(bytesConstRef _block, BlockChain const& _bc, bool _checkNonce = true);
 
+	/// Play back the transactions and uncles of the given block, whose header is already in m_currentBlock and whose
+	/// internals have been verified. Throws on failure. @returns the additional total difficulty.
+	u256 playback(bytesConstRef _block, BlockChain const& _bc);
+
 	/// Finalise the block, applying the earned rewards.
 	void applyRewards(Addresses const& _uncleAddresses);
 
@@ -292,9 +347,12 @@ private:
 	Transactions m_transactions;				///< The current list of transactions that we've included in the state.
 	TransactionReceipts m_receipts;				///< The corresponding list of transaction receipts.
 	std::set<h256> m_transactionSet;			///< The set of transaction hashes that we've included in the state.
+	unsigned m_txQueueWatermark = 0;			///< The TransactionQueue sequence number up to which we've synced.
 	OverlayDB m_lastTx;
 
 	mutable std::map<Address, Account> m_cache;	///< Our address cache. This stores the states of each address that has (or at least might have) been changed.
+	mutable std::vector<CacheChange> m_journal;	///< Changes made to m_cache since the outermost open checkpoint, oldest first.
+	unsigned m_checkpoints = 0;					///< The number of open checkpoints.
 
 	BlockInfo m_previousBlock;					///< The previous block's information.
 	BlockInfo m_currentBlock;					///< The current block's information.
@@ -320,7 +378,9 @@ template <class DB>
 void commit(std::map<Address, Account> const& _cache, DB& _db, TrieDB<Address, DB>& _state)
 {
 	for (auto const& i: _cache)
-		if (!i.second.isAlive())
+		if (!i.second.isDirty())
+			continue;
+		else if (!i.second.isAlive())
 			_state.remove(i.first);
 		else
 		{
@@ -0,0 +1,108 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file StateSnapshot.cpp
+ * @date 2014
+ */
+
+#include "StateSnapshot.h"
+
+#include <libdevcrypto/TrieDB.h>
+#include "State.h"
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+Account* StateSnapshot::account(Address _a, bool _requireCode) const
+{
+	if (!m_cache.count(_a))
+	{
+		auto it = m_state->m_cache.find(_a);
+		if (it != m_state->m_cache.end())
+			m_cache.insert(*it);
+	}
+	// Anything not yet in our cache comes from the trie; any code, from the DB. Either way only we are written to.
+	m_state->ensureCached(m_cache, _a, _requireCode, false);
+	auto it = m_cache.find(_a);
+	return it == m_cache.end() || !it->second.isAlive() ? nullptr : &it->second;
+}
+
+map<Address, u256> StateSnapshot::addresses() const
+{
+	map<Address, u256> ret;
+	for (auto const& i: m_state->m_cache)
+		if (i.second.isAlive())
+			ret[i.first] = i.second.balance();
+	for (auto const& i: m_state->m_state)
+		if (!m_state->m_cache.count(i.first))
+			ret[i.first] = RLP(i.second)[1].toInt<u256>();
+	return ret;
+}
+
+u256 StateSnapshot::balance(Address _id) const
+{
+	auto a = account(_id, false);
+	return a ? a->balance() : 0;
+}
+
+u256 StateSnapshot::transactionsFrom(Address _id) const
+{
+	auto a = account(_id, false);
+	return a ? a->nonce() : 0;
+}
+
+u256 StateSnapshot::storage(Address _id, u256 _memory) const
+{
+	auto a = account(_id, false);
+	if (!a)
+		return 0;
+
+	auto mit = a->storageOverlay().find(_memory);
+	if (mit != a->storageOverlay().end())
+		return mit->second;
+
+	TrieDB<h256, OverlayDB> memdb(const_cast<OverlayDB*>(&m_state->m_db), a->baseRoot());		// promise we won't change the overlay! :)
+	string payload = memdb.at(_memory);
+	u256 ret = payload.size() ? RLP(payload).toInt<u256>() : 0;
+	a->noteStorage(_memory, ret);
+	return ret;
+}
+
+map<u256, u256> StateSnapshot::storage(Address _id) const
+{
+	map<u256, u256> ret;
+	if (auto a = account(_id, false))
+	{
+		if (a->baseRoot())
+		{
+			TrieDB<h256, OverlayDB> memdb(const_cast<OverlayDB*>(&m_state->m_db), a->baseRoot());	// promise we won't alter the overlay! :)
+			for (auto const& i: memdb)
+				ret[i.first] = RLP(i.second).toInt<u256>();
+		}
+		for (auto const& i: a->storageOverlay())
+			if (i.second)
+				ret[i.first] = i.second;
+			else
+				ret.erase(i.first);
+	}
+	return ret;
+}
+
+bytes StateSnapshot::code(Address _contract) const
+{
+	auto a = account(_contract, true);
+	return a ? a->code() : bytes();
+}
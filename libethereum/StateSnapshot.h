@@ -0,0 +1,80 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file StateSnapshot.h
+ * @date 2014
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <libdevcore/Common.h>
+#include <libethcore/CommonEth.h>
+#include "Account.h"
+
+namespace dev
+{
+namespace eth
+{
+
+class State;
+
+/**
+ * @brief A cheap, read-only view of a State that is shared with other views and never changed.
+ *
+ * The shared State (its trie root, overlay and cache of changed accounts) is only ever read. Each view instead
+ * keeps a cache of its own, into which the accounts it looks at are copied on first use. Any number of views, on
+ * any number of threads, may therefore read the same State at once without copying it or taking a lock.
+ */
+class StateSnapshot
+{
+public:
+	/// Construct a view of @a _s, which must not be changed (or used other than through views) hereafter.
+	explicit StateSnapshot(std::shared_ptr<State const> const& _s): m_state(_s) {}
+
+	/// @returns the set containing all addresses currently in use in Ethereum, with their balances.
+	std::map<Address, u256> addresses() const;
+
+	/// Get an account's balance. @returns 0 if the address has never been used.
+	u256 balance(Address _id) const;
+
+	/// Get the number of transactions a particular address has sent (used for the transaction nonce).
+	u256 transactionsFrom(Address _id) const;
+
+	/// Get the value of a storage position of an account. @returns 0 if no account exists at that address.
+	u256 storage(Address _contract, u256 _location) const;
+
+	/// Get the storage of an account. @returns a map of all storage positions and their values.
+	std::map<u256, u256> storage(Address _contract) const;
+
+	/// Get the code of an account. @returns bytes() if no account exists at that address.
+	bytes code(Address _contract) const;
+
+	/// @returns the shared State we're a view of.
+	State const& state() const { return *m_state; }
+
+private:
+	/// @returns our copy of the account at @a _a, taken from the shared State's cache if it's been changed there
+	/// and otherwise from its trie; nullptr if there is none.
+	Account* account(Address _a, bool _requireCode) const;
+
+	std::shared_ptr<State const> m_state;			///< The shared State; only ever read.
+	mutable std::map<Address, Account> m_cache;		///< The accounts we've looked at so far.
+};
+
+}
+}
@@ -19,8 +19,11 @@
  * @date 2014
  */
 
+#include <unordered_map>
 #include <libdevcore/vector_ref.h>
 #include <libdevcore/Log.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcrypto/Common.h>
 #include <libethcore/Exceptions.h>
 #include "Transaction.h"
@@ -30,6 +33,25 @@ using namespace dev::eth;
 
 #define ETH_ADDRESS_DEBUG 0
 
+namespace
+{
+
+/// Number of recovered senders we remember before starting afresh.
+static const unsigned c_maxCachedSenders = 65536;
+
+/// A recovered sender, along with the signature it was recovered from.
+struct CachedSender
+{
+	Signature sig;
+	Address sender;
+};
+
+/// Senders recovered so far, keyed by the hash of the transaction they signed (i.e. without the signature).
+Mutex x_senders;
+unordered_map<h256, CachedSender> s_senders;
+
+}
+
 Transaction::Transaction(bytesConstRef _rlpData, bool _checkSender)
 {
 	int field = 0;
@@ -74,14 +96,61 @@ Address Transaction::sender() const
 {
 	if (!m_sender)
 	{
-		auto p = recover(m_vrs, sha3(WithoutSignature));
+		h256 h = sha3(WithoutSignature);
+		Signature sig = m_vrs;
+		{
+			Guard l(x_senders);
+			auto it = s_senders.find(h);
+			if (it != s_senders.end() && it->second.sig == sig)
+				return m_sender = it->second.sender;
+		}
+
+		auto p = recover(sig, h);
 		if (!p)
 			BOOST_THROW_EXCEPTION(InvalidSignature());
 		m_sender = right160(dev::sha3(bytesConstRef(p.data(), sizeof(p))));
+
+		Guard l(x_senders);
+		if (s_senders.size() >= c_maxCachedSenders)
+			s_senders.clear();
+		s_senders[h] = CachedSender{sig, m_sender};
 	}
 	return m_sender;
 }
 
+void dev::eth::recoverSenders(Transactions const& _ts)
+{
+	ThreadPool::shared().parallelFor(_ts.size(), [&](unsigned i)
+	{
+		try
+		{
+			_ts[i].sender();
+		}
+		catch (...) {}
+	});
+}
+
+void dev::eth::recoverSenders(vector<bytesConstRef> const& _rlps)
+{
+	Transactions ts;
+	ts.reserve(_rlps.size());
+	for (auto const& i: _rlps)
+		try
+		{
+			ts.push_back(Transaction(i));
+		}
+		catch (...) {}
+	recoverSenders(ts);
+}
+
+void dev::eth::recoverSenders(RLP const& _txList)
+{
+	vector<bytesConstRef> rlps;
+	for (auto const& i: _txList)
+		rlps.push_back(i.data());
+	recoverSenders(rlps);
+}
+
 void Transaction::sign(Secret _priv)
 {
 	auto sig = dev::sign(_priv, sha3(WithoutSignature));
@@ -142,6 +142,17 @@ private:
 /// Nice name for vector of Transaction.
 using Transactions = std::vector<Transaction>;
 
+/// Determines the sender of each of @a _ts, spreading the signature recoveries over this thread and the shared ThreadPool. Senders are
+/// cached on each Transaction and also process-wide, so that later decodings of the same transactions (e.g. when the
+/// block is finally executed) needn't recover them again. Transactions with invalid signatures are silently skipped.
+void recoverSenders(Transactions const& _ts);
+
+/// As recoverSenders(Transactions), but for serialised transactions. Malformed ones are silently skipped.
+void recoverSenders(std::vector<bytesConstRef> const& _rlps);
+
+/// As recoverSenders(Transactions), but for an RLP list of serialised transactions, such as that of a block.
+void recoverSenders(RLP const& _txList);
+
 /// Simple human-readable stream-shift operator.
 inline std::ostream& operator<<(std::ostream& _out, Transaction const& _t)
 {
@@ -21,6 +21,7 @@
 
 #include "TransactionQueue.h"
 
+#include <queue>
 #include <libdevcore/Log.h>
 #include <libethcore/Exceptions.h>
 #include "Transaction.h"
@@ -32,22 +33,20 @@ bool TransactionQueue::import(bytesConstRef _transactionRLP)
 {
 	// Check if we already know this transaction.
 	h256 h = sha3(_transactionRLP);
+	{
+		ReadGuard l(m_lock);
+		if (m_known.count(h))
+			return false;
+	}
 
-	UpgradableGuard l(m_lock);
-	if (m_known.count(h))
-		return false;
-
+	QueuedTransactionPtr q;
 	try
 	{
 		// Check validity of _transactionRLP as a transaction. To do this we just deserialise and attempt to determine the sender.
 		// If it doesn't work, the signature is bad.
 		// The transaction's nonce may yet be invalid (or, it could be "valid" but we may be missing a marginally older transaction).
 		Transaction t(_transactionRLP, true);
-
-		UpgradeGuard ul(l);
-		// If valid, append to blocks.
-		m_current[h] = _transactionRLP.toBytes();
-		m_known.insert(h);
+		q = make_shared<QueuedTransaction const>(QueuedTransaction{h, _transactionRLP.toBytes(), t.sender(), t.nonce(), t.gasPrice()});
 	}
 	catch (Exception const& _e)
 	{
@@ -60,47 +59,142 @@ bool TransactionQueue::import(bytesConstRef _transactionRLP)
 		return false;
 	}
 
+	{
+		WriteGuard l(m_lock);
+		// Another thread may have imported it while we were checking it.
+		if (!m_known.insert(make_pair(h, make_pair(q, 0))).second)
+			return false;
+		makeCurrent(q);
+	}
+
+	if (m_onReady)
+		m_onReady();
 	return true;
 }
 
-void TransactionQueue::setFuture(std::pair<h256, bytes> const& _t)
+shared_ptr<QueuedTransactions const> TransactionQueue::transactions() const
 {
-	WriteGuard l(m_lock);
-	if (m_current.count(_t.first))
+	ReadGuard l(m_lock);
+	Guard sl(x_snapshot);
+	if (!m_snapshot)
+		m_snapshot = make_shared<QueuedTransactions const>(merge(m_current));
+	return m_snapshot;
+}
+
+QueuedTransactions TransactionQueue::transactionsSince(unsigned& io_watermark) const
+{
+	ReadGuard l(m_lock);
+	BySender since;
+	for (auto it = m_ready.upper_bound(io_watermark); it != m_ready.end(); ++it)
+		since[it->second->sender].insert(make_pair(it->second->nonce, it->second));
+	io_watermark = m_lastSequence;
+	return merge(since);
+}
+
+QueuedTransactions TransactionQueue::merge(BySender const& _set)
+{
+	// Always take next whichever of the senders' first transactions pays the most for gas.
+	using Range = pair<BySender::mapped_type::const_iterator, BySender::mapped_type::const_iterator>;
+	auto cheaper = [](Range const& _a, Range const& _b) { return _a.first->second->gasPrice < _b.first->second->gasPrice; };
+	priority_queue<Range, vector<Range>, decltype(cheaper)> heads(cheaper);
+	size_t n = 0;
+	for (auto const& i: _set)
 	{
-		m_current.erase(_t.first);
-		m_unknown.insert(make_pair(Transaction(_t.second).sender(), _t));
+		heads.push(make_pair(i.second.begin(), i.second.end()));
+		n += i.second.size();
 	}
+
+	QueuedTransactions ret;
+	ret.reserve(n);
+	while (!heads.empty())
+	{
+		Range r = heads.top();
+		heads.pop();
+		ret.push_back(r.first->second);
+		if (++r.first != r.second)
+			heads.push(r);
+	}
+	return ret;
 }
 
-void TransactionQueue::noteGood(std::pair<h256, bytes> const& _t)
+pair<unsigned, unsigned> TransactionQueue::items() const
 {
-	WriteGuard l(m_lock);
-	auto r = m_unknown.equal_range(Transaction(_t.second).sender());
+	ReadGuard l(m_lock);
+	unsigned future = 0;
+	for (auto const& i: m_future)
+		future += i.second.size();
+	return make_pair(m_known.size() - future, future);
+}
+
+bool TransactionQueue::remove(BySender& _set, QueuedTransactionPtr const& _t)
+{
+	auto s = _set.find(_t->sender);
+	if (s == _set.end())
+		return false;
+	auto r = s->second.equal_range(_t->nonce);
 	for (auto it = r.first; it != r.second; ++it)
-		m_current.insert(it->second);
-	m_unknown.erase(r.first, r.second);
+		if (it->second == _t)
+		{
+			s->second.erase(it);
+			if (s->second.empty())
+				_set.erase(s);
+			return true;
+		}
+	return false;
 }
 
-void TransactionQueue::drop(h256 _txHash)
+void TransactionQueue::makeCurrent(QueuedTransactionPtr const& _t)
 {
-	UpgradableGuard l(m_lock);
+	m_current[_t->sender].insert(make_pair(_t->nonce, _t));
+	m_known[_t->hash].second = ++m_lastSequence;
+	m_ready[m_lastSequence] = _t;
+	m_snapshot.reset();
+}
 
-	if (!m_known.count(_txHash))
-		return;
+bool TransactionQueue::removeCurrent(QueuedTransactionPtr const& _t)
+{
+	if (!remove(m_current, _t))
+		return false;
+	unsigned& seq = m_known[_t->hash].second;
+	m_ready.erase(seq);
+	seq = 0;
+	m_snapshot.reset();
+	return true;
+}
 
-	UpgradeGuard ul(l);
-	m_known.erase(_txHash);
+void TransactionQueue::setFuture(h256 _txHash)
+{
+	WriteGuard l(m_lock);
+	auto it = m_known.find(_txHash);
+	if (it != m_known.end() && removeCurrent(it->second.first))
+		m_future[it->second.first->sender].insert(make_pair(it->second.first->nonce, it->second.first));
+}
 
-	if (m_current.count(_txHash))
-		m_current.erase(_txHash);
-	else
+void TransactionQueue::noteGood(Address _sender)
+{
+	{
+		ReadGuard l(m_lock);
+		if (!m_future.count(_sender))
+			return;
+	}
+	WriteGuard l(m_lock);
+	auto it = m_future.find(_sender);
+	if (it != m_future.end())
 	{
-		for (auto i = m_unknown.begin(); i != m_unknown.end(); ++i)
-			if (i->second.first == _txHash)
-			{
-				m_unknown.erase(i);
-				break;
-			}
+		for (auto const& i: it->second)
+			makeCurrent(i.second);
+		m_future.erase(it);
 	}
 }
+
+void TransactionQueue::drop(h256 _txHash)
+{
+	WriteGuard l(m_lock);
+	auto it = m_known.find(_txHash);
+	if (it == m_known.end())
+		return;
+
+	if (!removeCurrent(it->second.first))
+		remove(m_future, it->second.first);
+	m_known.erase(it);
+}
@@ -21,6 +21,9 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <boost/thread.hpp>
 #include <libdevcore/Common.h>
 #include "libethcore/CommonEth.h"
@@ -34,7 +37,30 @@ namespace eth
 class BlockChain;
 
 /**
- * @brief A queue of Transactions, each stored as RLP.
+ * @brief A transaction as held in the TransactionQueue, together with the fields it's ordered by. Immutable.
+ */
+struct QueuedTransaction
+{
+	h256 hash;
+	bytes rlp;
+	Address sender;
+	u256 nonce;
+	u256 gasPrice;
+};
+
+using QueuedTransactionPtr = std::shared_ptr<QueuedTransaction const>;
+using QueuedTransactions = std::vector<QueuedTransactionPtr>;
+
+/**
+ * @brief A queue of Transactions, kept per sender in nonce order.
+ *
+ * Transactions whose nonce is thought to be ahead of their sender's are set aside as future transactions until
+ * the sender has a good one. The rest are handed out by transactions() as a snapshot, which is only rebuilt after
+ * the queue changes, so it's cheap to ask for repeatedly and to iterate without holding any lock. Each time a
+ * transaction becomes current it's given a new sequence number, so that transactionsSince() can give just those
+ * that have become current since some earlier call.
+ *
+ * Signatures are checked before the queue is locked, so any number of threads may import concurrently.
  * @threadsafe
  */
 class TransactionQueue
@@ -46,19 +72,50 @@ public:
 
 	void drop(h256 _txHash);
 
-	std::map<h256, bytes> transactions() const { ReadGuard l(m_lock); return m_current; }
-	std::pair<unsigned, unsigned> items() const { ReadGuard l(m_lock); return std::make_pair(m_current.size(), m_unknown.size()); }
+	/// @returns the current (i.e. not future) transactions, best gas price first but with each sender's in nonce order.
+	std::shared_ptr<QueuedTransactions const> transactions() const;
+	std::pair<unsigned, unsigned> items() const;
+
+	/// @returns those current transactions that became current after the sequence number @a io_watermark, ordered as
+	/// by transactions(), and sets @a io_watermark to the latest sequence number. Start with a watermark of zero.
+	QueuedTransactions transactionsSince(unsigned& io_watermark) const;
 
-	void setFuture(std::pair<h256, bytes> const& _t);
-	void noteGood(std::pair<h256, bytes> const& _t);
+	/// Set aside the transaction @a _txHash until its sender has a good transaction.
+	void setFuture(h256 _txHash);
+	/// Note that @a _sender has had a good transaction, so any of theirs that were set aside may be good now too.
+	void noteGood(Address _sender);
 
-	void clear() { WriteGuard l(m_lock); m_known.clear(); m_current.clear(); m_unknown.clear(); }
+	void clear() { WriteGuard l(m_lock); m_known.clear(); m_current.clear(); m_future.clear(); m_ready.clear(); m_snapshot.reset(); }
+
+	/// Set the function to be called whenever import() adds a new transaction. It's called from the importing
+	/// thread, so should be quick; typically it just wakes up whatever handles the new transactions.
+	void onReady(std::function<void()> const& _f) { m_onReady = _f; }
 
 private:
-	mutable boost::shared_mutex m_lock;							///< General lock.
-	std::set<h256> m_known;										///< Hashes of transactions in both sets.
-	std::map<h256, bytes> m_current;							///< Map of SHA3(tx) to tx.
-	std::multimap<Address, std::pair<h256, bytes>> m_unknown;	///< For transactions that have a future nonce; we map their sender address to the tx stuff, and insert once the sender has a valid TX.
+	/// Transactions of each sender, by nonce.
+	using BySender = std::map<Address, std::multimap<u256, QueuedTransactionPtr>>;
+
+	/// @returns the transactions of @a _set, best gas price first but with each sender's in nonce order.
+	static QueuedTransactions merge(BySender const& _set);
+
+	/// Removes @a _t from @a _set. @returns true if it was there.
+	static bool remove(BySender& _set, QueuedTransactionPtr const& _t);
+
+	/// Puts the known transaction @a _t into m_current under a new sequence number.
+	void makeCurrent(QueuedTransactionPtr const& _t);
+
+	/// Takes the known transaction @a _t out of m_current. @returns true if it was there.
+	bool removeCurrent(QueuedTransactionPtr const& _t);
+
+	mutable boost::shared_mutex m_lock;								///< General lock.
+	std::unordered_map<h256, std::pair<QueuedTransactionPtr, unsigned>> m_known;	///< All transactions, current and future, by hash, with their key in m_ready (zero if future).
+	BySender m_current;												///< Transactions that may be executable now.
+	BySender m_future;												///< For transactions that have a future nonce; inserted once the sender has a valid TX.
+	std::map<unsigned, QueuedTransactionPtr> m_ready;				///< The transactions of m_current by the sequence number they became current under.
+	unsigned m_lastSequence = 0;									///< The latest sequence number given out.
+	mutable std::shared_ptr<QueuedTransactions const> m_snapshot;	///< The current transactions, in order; null if they've changed since.
+	mutable Mutex x_snapshot;										///< Lock for building m_snapshot, which readers may do.
+	std::function<void()> m_onReady;								///< Called after a new transaction has been imported.
 };
 
 }
@@ -0,0 +1,164 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Arith256.h
+ * @date 2014
+ *
+ * Fast paths for the commonest EVM word operations, done directly on the four 64-bit limbs of a u256 rather than
+ * through the generic multiprecision routines. All arithmetic is modulo 2^256, as in the VM. The result may alias
+ * either operand. Where 128-bit integers aren't available the generic routines are used instead.
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+
+#if defined(__SIZEOF_INT128__) && defined(BOOST_HAS_INT128)
+#define ETH_FAST_ARITH 1
+#endif
+
+namespace dev
+{
+namespace eth
+{
+namespace arith
+{
+
+#if ETH_FAST_ARITH
+
+static_assert(sizeof(boost::multiprecision::limb_type) == 8, "Fast 256-bit arithmetic needs 64-bit limbs.");
+
+/// Little-endian limbs of a 256-bit word.
+struct Word
+{
+	uint64_t l[4];
+};
+
+inline Word load(u256 const& _v)
+{
+	auto const& b = _v.backend();
+	unsigned n = b.size();
+	auto p = b.limbs();
+	return Word{{p[0], n > 1 ? p[1] : 0, n > 2 ? p[2] : 0, n > 3 ? p[3] : 0}};
+}
+
+inline void store(Word const& _w, u256& o_v)
+{
+	auto& b = o_v.backend();
+	b.resize(4, 4);
+	auto p = b.limbs();
+	p[0] = _w.l[0];
+	p[1] = _w.l[1];
+	p[2] = _w.l[2];
+	p[3] = _w.l[3];
+	b.normalize();
+}
+
+inline void add(u256 const& _a, u256 const& _b, u256& o_r)
+{
+	Word a = load(_a);
+	Word b = load(_b);
+	Word r;
+	unsigned __int128 c = 0;
+	for (unsigned i = 0; i < 4; ++i)
+	{
+		c += (unsigned __int128)a.l[i] + b.l[i];
+		r.l[i] = (uint64_t)c;
+		c >>= 64;
+	}
+	store(r, o_r);
+}
+
+inline void sub(u256 const& _a, u256 const& _b, u256& o_r)
+{
+	Word a = load(_a);
+	Word b = load(_b);
+	Word r;
+	uint64_t borrow = 0;
+	for (unsigned i = 0; i < 4; ++i)
+	{
+		uint64_t d = a.l[i] - b.l[i];
+		uint64_t nb = (a.l[i] < b.l[i]) | (d < borrow);
+		r.l[i] = d - borrow;
+		borrow = nb;
+	}
+	store(r, o_r);
+}
+
+inline void mul(u256 const& _a, u256 const& _b, u256& o_r)
+{
+	Word a = load(_a);
+	Word b = load(_b);
+	Word r{{0, 0, 0, 0}};
+	for (unsigned i = 0; i < 4; ++i)
+	{
+		unsigned __int128 c = 0;
+		for (unsigned j = 0; i + j < 4; ++j)
+		{
+			c += (unsigned __int128)a.l[i] * b.l[j] + r.l[i + j];
+			r.l[i + j] = (uint64_t)c;
+			c >>= 64;
+		}
+	}
+	store(r, o_r);
+}
+
+inline bool lt(u256 const& _a, u256 const& _b)
+{
+	Word a = load(_a);
+	Word b = load(_b);
+	for (unsigned i = 4; i--;)
+		if (a.l[i] != b.l[i])
+			return a.l[i] < b.l[i];
+	return false;
+}
+
+inline bool eq(u256 const& _a, u256 const& _b)
+{
+	Word a = load(_a);
+	Word b = load(_b);
+	return a.l[0] == b.l[0] && a.l[1] == b.l[1] && a.l[2] == b.l[2] && a.l[3] == b.l[3];
+}
+
+inline void bitAnd(u256 const& _a, u256 const& _b, u256& o_r)
+{
+	Word a = load(_a);
+	Word b = load(_b);
+	store(Word{{a.l[0] & b.l[0], a.l[1] & b.l[1], a.l[2] & b.l[2], a.l[3] & b.l[3]}}, o_r);
+}
+
+inline void bitOr(u256 const& _a, u256 const& _b, u256& o_r)
+{
+	Word a = load(_a);
+	Word b = load(_b);
+	store(Word{{a.l[0] | b.l[0], a.l[1] | b.l[1], a.l[2] | b.l[2], a.l[3] | b.l[3]}}, o_r);
+}
+
+#else
+
+inline void add(u256 const& _a, u256 const& _b, u256& o_r) { o_r = _a + _b; }
+inline void sub(u256 const& _a, u256 const& _b, u256& o_r) { o_r = _a - _b; }
+inline void mul(u256 const& _a, u256 const& _b, u256& o_r) { o_r = _a * _b; }
+inline bool lt(u256 const& _a, u256 const& _b) { return _a < _b; }
+inline bool eq(u256 const& _a, u256 const& _b) { return _a == _b; }
+inline void bitAnd(u256 const& _a, u256 const& _b, u256& o_r) { o_r = _a & _b; }
+inline void bitOr(u256 const& _a, u256 const& _b, u256& o_r) { o_r = _a | _b; }
+
+#endif
+
+}
+}
+}
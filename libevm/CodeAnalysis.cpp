@@ -0,0 +1,160 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file CodeAnalysis.cpp
+ * @date 2014
+ */
+
+#include "CodeAnalysis.h"
+
+#include <unordered_map>
+#include <libdevcore/Guards.h>
+#include "FeeStructure.h"
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+
+/// Number of distinct pieces of code whose analyses we keep around.
+static const unsigned c_maxCachedAnalyses = 4096;
+
+/// Marks a position in the push index that isn't the start of a PUSH on an instruction boundary.
+static const unsigned c_noPush = (unsigned)-1;
+
+Mutex x_analyses;
+unordered_map<h256, shared_ptr<CodeAnalysis const>> s_analyses;
+
+unsigned pushSize(Instruction _inst)
+{
+	return _inst >= Instruction::PUSH1 && _inst <= Instruction::PUSH32 ? (unsigned)_inst - (unsigned)Instruction::PUSH1 + 1 : 0;
+}
+
+}
+
+CodeAnalysis::CodeAnalysis(bytesConstRef _code):
+	m_code(_code.size() + 32),
+	m_jumpDests(_code.size()),
+	m_pushIndex(_code.size(), c_noPush),
+	m_blockGas(_code.size())
+{
+	memcpy(m_code.data(), _code.data(), _code.size());
+	for (size_t i = 0; i < _code.size(); ++i)
+		if (_code[i] == (byte)Instruction::JUMPDEST)
+			m_jumpDests[i] = true;
+
+	// Pull out the immediates of the PUSHes on instruction boundaries; anything else is decoded on demand by push().
+	for (size_t i = 0; i < _code.size(); i += 1 + pushSize((Instruction)m_code[i]))
+		if (unsigned n = pushSize((Instruction)m_code[i]))
+		{
+			m_pushIndex[i] = m_pushes.size();
+			m_pushes.push_back(fromBigEndian<u256>(bytesConstRef(m_code.data() + i + 1, n)));
+		}
+
+	// Work backwards so the run following each position is known by the time we get to it.
+	for (size_t i = _code.size(); i--;)
+	{
+		Instruction inst = (Instruction)m_code[i];
+		size_t next = i + 1 + pushSize(inst);
+		m_blockGas[i] = staticGas(inst);
+		if (!endsBlock(inst) && next < _code.size() && !m_jumpDests[next])
+			m_blockGas[i] += m_blockGas[next];
+	}
+}
+
+shared_ptr<CodeAnalysis const> CodeAnalysis::get(h256 const& _codeHash, bytesConstRef _code)
+{
+	if (!_codeHash)
+		return make_shared<CodeAnalysis>(_code);
+
+	{
+		Guard l(x_analyses);
+		auto it = s_analyses.find(_codeHash);
+		if (it != s_analyses.end())
+			return it->second;
+	}
+
+	auto ret = make_shared<CodeAnalysis>(_code);
+	Guard l(x_analyses);
+	if (s_analyses.size() >= c_maxCachedAnalyses)
+		s_analyses.clear();
+	s_analyses[_codeHash] = ret;
+	return ret;
+}
+
+u256 CodeAnalysis::push(uint64_t _pc) const
+{
+	if (_pc < m_pushIndex.size() && m_pushIndex[(size_t)_pc] != c_noPush)
+		return m_pushes[m_pushIndex[(size_t)_pc]];
+
+	// Not on an instruction boundary (we got here by jumping into a PUSH's data); decode it directly.
+	u256 ret;
+	for (uint64_t i = _pc + 1, e = _pc + 1 + pushSize(instruction(_pc)); i < e; ++i)
+		ret = (ret << 8) | (i < m_code.size() ? m_code[(size_t)i] : 0);
+	return ret;
+}
+
+uint64_t CodeAnalysis::staticGas(Instruction _inst)
+{
+	switch (_inst)
+	{
+	case Instruction::STOP:
+	case Instruction::SUICIDE:
+	case Instruction::SSTORE:
+		return 0;
+	case Instruction::SLOAD:
+		return (uint64_t)c_sloadGas;
+	case Instruction::BALANCE:
+		return (uint64_t)c_balanceGas;
+	case Instruction::SHA3:
+		return (uint64_t)c_sha3Gas;
+	case Instruction::LOG0:
+	case Instruction::LOG1:
+	case Instruction::LOG2:
+	case Instruction::LOG3:
+	case Instruction::LOG4:
+		return (uint64_t)(c_logGas + c_logTopicGas * ((unsigned)_inst - (unsigned)Instruction::LOG0));
+	case Instruction::CALL:
+	case Instruction::CALLCODE:
+		return (uint64_t)c_callGas;
+	case Instruction::CREATE:
+		return (uint64_t)c_createGas;
+	case Instruction::EXP:
+		return (uint64_t)c_expGas;
+	default:
+		return isValidInstruction(_inst) ? (uint64_t)c_stepGas : 0;
+	}
+}
+
+bool CodeAnalysis::endsBlock(Instruction _inst)
+{
+	switch (_inst)
+	{
+	case Instruction::STOP:
+	case Instruction::RETURN:
+	case Instruction::SUICIDE:
+	case Instruction::JUMP:
+	case Instruction::JUMPI:
+	case Instruction::GAS:
+	case Instruction::CALL:
+	case Instruction::CALLCODE:
+	case Instruction::CREATE:
+		return true;
+	default:
+		return !isValidInstruction(_inst);
+	}
+}
@@ -0,0 +1,80 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file CodeAnalysis.h
+ * @date 2014
+ */
+
+#pragma once
+
+#include <memory>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libevmcore/Instruction.h>
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * @brief The product of a single decoding pass over a piece of EVM code, as used by VM::go.
+ *
+ * Holds the code itself (zero-padded, so that a PUSH at the very end reads zeroes as getCode() would), the bitmap
+ * of valid jump destinations, the pre-extracted immediate of every PUSH that lies on an instruction boundary and,
+ * for every position, the static gas of the straight-line run of instructions starting there. A run ends after any
+ * instruction that transfers control or observes the remaining gas (JUMP, JUMPI, GAS, CALL, CREATE, ...) and before
+ * any JUMPDEST; see endsBlock().
+ *
+ * Instances are immutable once built, so they may be shared between VMs (and threads) through get().
+ */
+class CodeAnalysis
+{
+public:
+	explicit CodeAnalysis(bytesConstRef _code);
+
+	/// @returns the analysis of @a _code, whose SHA3 is @a _codeHash, reusing an earlier one if it's still cached.
+	/// If @a _codeHash is null (e.g. for init code, which is only ever run once) the analysis is not cached.
+	static std::shared_ptr<CodeAnalysis const> get(h256 const& _codeHash, bytesConstRef _code);
+
+	/// @returns the instruction at @a _pc; STOP if beyond the end of the code.
+	Instruction instruction(uint64_t _pc) const { return _pc < m_code.size() ? (Instruction)m_code[(size_t)_pc] : Instruction::STOP; }
+
+	/// @returns the value pushed by the PUSH instruction at @a _pc.
+	u256 push(uint64_t _pc) const;
+
+	/// @returns true if @a _pc is a valid jump destination.
+	bool isJumpDest(u256 const& _pc) const { return _pc < m_jumpDests.size() && m_jumpDests[(size_t)_pc]; }
+
+	/// @returns the total static gas of the instructions from @a _pc up to and including the one ending its block.
+	uint64_t blockGas(uint64_t _pc) const { return _pc < m_blockGas.size() ? m_blockGas[(size_t)_pc] : 0; }
+
+	/// @returns the part of @a _inst's gas cost that doesn't depend on its operands.
+	static uint64_t staticGas(Instruction _inst);
+
+	/// @returns true if no further instruction may be charged for together with @a _inst.
+	static bool endsBlock(Instruction _inst);
+
+private:
+	bytes m_code;						///< The code, with 32 zero bytes of padding.
+	std::vector<bool> m_jumpDests;		///< One entry per byte of the (unpadded) code.
+	std::vector<unsigned> m_pushIndex;	///< Index into m_pushes of the immediate for a PUSH at each position.
+	u256s m_pushes;						///< The immediates of each PUSH on an instruction boundary, in code order.
+	std::vector<uint64_t> m_blockGas;	///< Static gas of the run starting at each position.
+};
+
+}
+}
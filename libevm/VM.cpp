@@ -29,5 +29,5 @@ void VM::reset(u256 _gas) noexcept
 {
 	VMFace::reset(_gas);
 	m_curPC = 0;
-	m_jumpDests.clear();
+	m_code.reset();
 }
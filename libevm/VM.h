@@ -29,6 +29,8 @@
 #include <libethcore/BlockInfo.h>
 #include "FeeStructure.h"
 #include "VMFace.h"
+#include "CodeAnalysis.h"
+#include "Arith256.h"
 
 namespace dev
 {
@@ -47,7 +49,27 @@ inline u256 fromAddress(Address _a)
 	return (u160)_a;
 }
 
+/// The largest amount of gas, and of memory in bytes, the VM will consider paying for.
+static const uint64_t c_maxGas = (uint64_t)1 << 62;
+static const uint64_t c_maxMemory = (uint64_t)1 << 32;
+
+/// Stack slots allocated up front; deeper stacks still work, but cost a reallocation.
+static const unsigned c_stackReserve = 1024;
+
+/// Memory is allocated in multiples of this many bytes.
+static const size_t c_memoryChunk = 4096;
+
 /**
+ * @brief The EVM interpreter.
+ *
+ * Code is decoded once into a CodeAnalysis (shared between VMs running the same code), and the gas and memory costs
+ * of each instruction are worked out in 64 bits; the remaining gas itself is still kept as a u256. When neither
+ * tracing nor single-stepping, the static gas of each straight-line run is charged as a whole on entering it; since
+ * any VM exception consumes all gas and reverts, this is indistinguishable from charging it per instruction. Amounts
+ * of gas above 2^62 can never be paid for and are treated as out-of-gas, as are memory accesses beyond 4GB.
+ *
+ * The stack's storage is allocated once, with room for c_stackReserve items, and memory grows in chunks whose size
+ * at least doubles, so neither normally touches the allocator once execution is under way.
  */
 class VM: public VMFace
 {
@@ -57,7 +79,7 @@ public:
 	virtual bytesConstRef go(ExtVMFace& _ext, OnOpFunc const& _onOp = {}, uint64_t _steps = (uint64_t)-1) override final;
 
 	void require(u256 _n) { if (m_stack.size() < _n) { if (m_onFail) m_onFail(); BOOST_THROW_EXCEPTION(StackTooSmall() << RequirementError((bigint)_n, (bigint)m_stack.size())); } }
-	void requireMem(unsigned _n) { if (m_temp.size() < _n) { m_temp.resize(_n); } }
+	void requireMem(unsigned _n) { if (m_temp.size() < _n) { growMem(_n); } }
 
 	u256 curPC() const { return m_curPC; }
 
@@ -68,41 +90,70 @@ private:
 	friend class VMFactory;
 
 	/// Construct VM object.
-	explicit VM(u256 _gas): VMFace(_gas) {}
+	explicit VM(u256 _gas): VMFace(_gas) { m_stack.reserve(c_stackReserve); }
+
+	/// @returns @a _v as an amount of gas; throws OutOfGas if it is too large ever to be paid for.
+	uint64_t gasOf(u256 const& _v) { if (_v > c_maxGas) outOfGas(); return (uint64_t)_v; }
+
+	/// @returns the memory size needed to access @a _size bytes at @a _offset; throws OutOfGas if that's unaddressable.
+	uint64_t memNeed(u256 const& _offset, u256 const& _size) { if (!_size) return 0; if (_offset > c_maxMemory || _size > c_maxMemory - _offset) outOfGas(); return (uint64_t)_offset + (uint64_t)_size; }
+
+	/// Charge @a _gas, throwing OutOfGas (and leaving no gas) if we haven't got it.
+	void useGas(uint64_t _gas) { if (m_gas < _gas) outOfGas(); m_gas -= _gas; }
+
+	void outOfGas() { m_gas = 0; BOOST_THROW_EXCEPTION(OutOfGas()); }
+
+	/// Extend memory to @a _size bytes, zero-filling only the new part and reallocating only when out of capacity.
+	void growMem(size_t _size)
+	{
+		if (_size > m_temp.capacity())
+			m_temp.reserve(std::max((_size + c_memoryChunk - 1) / c_memoryChunk * c_memoryChunk, m_temp.capacity() * 2));
+		m_temp.resize(_size);
+	}
 
-	u256 m_curPC = 0;
+	uint64_t m_curPC = 0;
 	bytes m_temp;
 	u256s m_stack;
-	std::set<u256> m_jumpDests;
+	std::shared_ptr<CodeAnalysis const> m_code;
 	std::function<void()> m_onFail;
 };
 
 // TODO: Move it to cpp file. Not done to make review easier.
 inline bytesConstRef VM::go(ExtVMFace& _ext, OnOpFunc const& _onOp, uint64_t _steps)
 {
-	auto memNeed = [](dev::u256 _offset, dev::u256 _size) { return _size ? (bigint)_offset + _size : (bigint)0; };
-
-	if (m_jumpDests.empty())
-		for (unsigned i = 0; i < _ext.code.size(); ++i)
-			if (_ext.code[i] == (byte)Instruction::JUMPDEST)
-				m_jumpDests.insert(i);
-
-	u256 nextPC = m_curPC + 1;
+	static const uint64_t sstoreSetGas = (uint64_t)c_sstoreSetGas;
+	static const uint64_t sstoreResetGas = (uint64_t)c_sstoreResetGas;
+	static const uint64_t sha3WordGas = (uint64_t)c_sha3WordGas;
+	static const uint64_t logDataGas = (uint64_t)c_logDataGas;
+	static const uint64_t expByteGas = (uint64_t)c_expByteGas;
+	static const uint64_t memoryGas = (uint64_t)c_memoryGas;
+	static const uint64_t copyGas = (uint64_t)c_copyGas;
+
+	if (!m_code)
+		m_code = CodeAnalysis::get(_ext.codeHash, &_ext.code);
+
+	// Static gas is charged a block at a time unless someone is watching each step.
+	bool const perOp = _onOp || _steps != (uint64_t)-1;
+	bool newBlock = true;
+
+	uint64_t nextPC = m_curPC + 1;
 	auto osteps = _steps;
 	for (bool stopped = false; !stopped && _steps--; m_curPC = nextPC, nextPC = m_curPC + 1)
 	{
 		// INSTRUCTION...
-		Instruction inst = (Instruction)_ext.getCode(m_curPC);
+		Instruction inst = m_code->instruction(m_curPC);
 
 		// FEES...
-		bigint runGas = c_stepGas;
-		bigint newTempSize = m_temp.size();
-		bigint copySize = 0;
+		if (!perOp && (newBlock || m_code->isJumpDest(m_curPC)))
+			useGas(m_code->blockGas(m_curPC));
+		uint64_t runGas = perOp ? CodeAnalysis::staticGas(inst) : 0;
+		uint64_t newTempSize = m_temp.size();
+		uint64_t copySize = 0;
 
 		auto onOperation = [&]()
 		{
 			if (_onOp)
-				_onOp(osteps - _steps - 1, inst, newTempSize > m_temp.size() ? (newTempSize - m_temp.size()) / 32 : bigint(0), runGas, this, &_ext);
+				_onOp(osteps - _steps - 1, inst, newTempSize > m_temp.size() ? (newTempSize - m_temp.size()) / 32 : 0, runGas, this, &_ext);
 		};
 		// should work, but just seems to result in immediate errorless exit on initial execution. yeah. weird.
 		//m_onFail = std::function<void()>(onOperation);
@@ -110,44 +161,38 @@ inline bytesConstRef VM::go(ExtVMFace& _ext, OnOpFunc const& _onOp, uint64_t _st
 		switch (inst)
 		{
 		case Instruction::STOP:
-			runGas = 0;
 			break;
 
 		case Instruction::SUICIDE:
 			require(1);
-			runGas = 0;
 			break;
 
 		case Instruction::SSTORE:
 			require(2);
 			if (!_ext.store(m_stack.back()) && m_stack[m_stack.size() - 2])
-				runGas = c_sstoreSetGas;
+				runGas += sstoreSetGas;
 			else if (_ext.store(m_stack.back()) && !m_stack[m_stack.size() - 2])
-			{
-				runGas = 0;
 				_ext.sub.refunds += c_sstoreRefundGas;
-			}
 			else
-				runGas = c_sstoreResetGas;
+				runGas += sstoreResetGas;
 			break;
 
 		case Instruction::SLOAD:
 			require(1);
-			runGas = c_sloadGas;
 			break;
 
 		// These all operate on memory and therefore potentially expand it:
 		case Instruction::MSTORE:
 			require(2);
-			newTempSize = (bigint)m_stack.back() + 32;
+			newTempSize = memNeed(m_stack.back(), 32);
 			break;
 		case Instruction::MSTORE8:
 			require(2);
-			newTempSize = (bigint)m_stack.back() + 1;
+			newTempSize = memNeed(m_stack.back(), 1);
 			break;
 		case Instruction::MLOAD:
 			require(1);
-			newTempSize = (bigint)m_stack.back() + 32;
+			newTempSize = memNeed(m_stack.back(), 32);
 			break;
 		case Instruction::RETURN:
 			require(2);
@@ -155,28 +200,27 @@ inline bytesConstRef VM::go(ExtVMFace& _ext, OnOpFunc const& _onOp, uint64_t _st
 			break;
 		case Instruction::SHA3:
 			require(2);
-			runGas = c_sha3Gas + (m_stack[m_stack.size() - 2] + 31) / 32 * c_sha3WordGas;
 			newTempSize = memNeed(m_stack.back(), m_stack[m_stack.size() - 2]);
+			runGas += (uint64_t)(m_stack[m_stack.size() - 2] + 31) / 32 * sha3WordGas;
 			break;
 		case Instruction::CALLDATACOPY:
 			require(3);
-			copySize = m_stack[m_stack.size() - 3];
 			newTempSize = memNeed(m_stack.back(), m_stack[m_stack.size() - 3]);
+			copySize = (uint64_t)m_stack[m_stack.size() - 3];
 			break;
 		case Instruction::CODECOPY:
 			require(3);
-			copySize = m_stack[m_stack.size() - 3];
 			newTempSize = memNeed(m_stack.back(), m_stack[m_stack.size() - 3]);
+			copySize = (uint64_t)m_stack[m_stack.size() - 3];
 			break;
 		case Instruction::EXTCODECOPY:
 			require(4);
-			copySize = m_stack[m_stack.size() - 4];
 			newTempSize = memNeed(m_stack[m_stack.size() - 2], m_stack[m_stack.size() - 4]);
+			copySize = (uint64_t)m_stack[m_stack.size() - 4];
 			break;
 			
 		case Instruction::BALANCE:
 			require(1);
-			runGas = c_balanceGas;
 			break;
 		case Instruction::LOG0:
 		case Instruction::LOG1:
@@ -186,32 +230,30 @@ inline bytesConstRef VM::go(ExtVMFace& _ext, OnOpFunc const& _onOp, uint64_t _st
 		{
 			unsigned n = (unsigned)inst - (unsigned)Instruction::LOG0;
 			require(n + 2);
-			runGas = c_logGas + c_logTopicGas * n + (bigint)c_logDataGas * m_stack[m_stack.size() - 2];
 			newTempSize = memNeed(m_stack[m_stack.size() - 1], m_stack[m_stack.size() - 2]);
+			runGas += logDataGas * (uint64_t)m_stack[m_stack.size() - 2];
 			break;
 		}
 
 		case Instruction::CALL:
 		case Instruction::CALLCODE:
 			require(7);
-			runGas = (bigint)c_callGas + m_stack[m_stack.size() - 1];
+			runGas += gasOf(m_stack[m_stack.size() - 1]);
 			newTempSize = std::max(memNeed(m_stack[m_stack.size() - 6], m_stack[m_stack.size() - 7]), memNeed(m_stack[m_stack.size() - 4], m_stack[m_stack.size() - 5]));
 			break;
 
 		case Instruction::CREATE:
-		{
 			require(3);
-			u256 inOff = m_stack[m_stack.size() - 2];
-			u256 inSize = m_stack[m_stack.size() - 3];
-			newTempSize = (bigint)inOff + inSize;
-			runGas = c_createGas;
+			// NOTE: Unlike the other memory-accessing instructions, CREATE expands memory even for empty init code.
+			if (m_stack[m_stack.size() - 2] > c_maxMemory || m_stack[m_stack.size() - 3] > c_maxMemory - m_stack[m_stack.size() - 2])
+				outOfGas();
+			newTempSize = (uint64_t)m_stack[m_stack.size() - 2] + (uint64_t)m_stack[m_stack.size() - 3];
 			break;
-		}
 		case Instruction::EXP:
 		{
 			require(2);
 			auto expon = m_stack[m_stack.size() - 2];
-			runGas = c_expGas + c_expByteGas * (32 - (h256(expon).firstBitSet() / 8));
+			runGas += expByteGas * (32 - (h256(expon).firstBitSet() / 8));
 			break;
 		}
 
@@ -342,40 +384,35 @@ inline bytesConstRef VM::go(ExtVMFace& _ext, OnOpFunc const& _onOp, uint64_t _st
 
 		newTempSize = (newTempSize + 31) / 32 * 32;
 		if (newTempSize > m_temp.size())
-			runGas += c_memoryGas * (newTempSize - m_temp.size()) / 32;
-		runGas += c_copyGas * (copySize + 31) / 32;
+			runGas += memoryGas * (newTempSize - m_temp.size()) / 32;
+		runGas += copyGas * (copySize + 31) / 32;
 
 		onOperation();
 //		if (_onOp)
 //			_onOp(osteps - _steps - 1, inst, newTempSize > m_temp.size() ? (newTempSize - m_temp.size()) / 32 : bigint(0), runGas, this, &_ext);
 
-		if (m_gas < runGas)
-		{
-			// Out of gas!
-			m_gas = 0;
-			BOOST_THROW_EXCEPTION(OutOfGas());
-		}
-
-		m_gas = (u256)((bigint)m_gas - runGas);
+		useGas(runGas);
 
 		if (newTempSize > m_temp.size())
-			m_temp.resize((size_t)newTempSize);
+			growMem((size_t)newTempSize);
+
+		newBlock = CodeAnalysis::endsBlock(inst);
 
 		// EXECUTE...
 		switch (inst)
 		{
 		case Instruction::ADD:
 			//pops two items and pushes S[-1] + S[-2] mod 2^256.
-			m_stack[m_stack.size() - 2] += m_stack.back();
+			arith::add(m_stack.back(), m_stack[m_stack.size() - 2], m_stack[m_stack.size() - 2]);
 			m_stack.pop_back();
 			break;
 		case Instruction::MUL:
 			//pops two items and pushes S[-1] * S[-2] mod 2^256.
-			m_stack[m_stack.size() - 2] *= m_stack.back();
+			arith::mul(m_stack.back(), m_stack[m_stack.size() - 2], m_stack[m_stack.size() - 2]);
 			m_stack.pop_back();
 			break;
 		case Instruction::SUB:
-			m_stack[m_stack.size() - 2] = m_stack.back() - m_stack[m_stack.size() - 2];
+			arith::sub(m_stack.back(), m_stack[m_stack.size() - 2], m_stack[m_stack.size() - 2]);
 			m_stack.pop_back();
 			break;
 		case Instruction::DIV:
@@ -406,7 +443,7 @@ inline bytesConstRef VM::go(ExtVMFace& _ext, OnOpFunc const& _onOp, uint64_t _st
 			m_stack.back() = ~m_stack.back();
 			break;
 		case Instruction::LT:
-			m_stack[m_stack.size() - 2] = m_stack.back() < m_stack[m_stack.size() - 2] ? 1 : 0;
+			m_stack[m_stack.size() - 2] = arith::lt(m_stack.back(), m_stack[m_stack.size() - 2]) ? 1 : 0;
 			m_stack.pop_back();
 			break;
 		case Instruction::GT:
@@ -422,18 +459,18 @@ inline bytesConstRef VM::go(ExtVMFace& _ext, OnOpFunc const& _onOp, uint64_t _st
 			m_stack.pop_back();
 			break;
 		case Instruction::EQ:
-			m_stack[m_stack.size() - 2] = m_stack.back() == m_stack[m_stack.size() - 2] ? 1 : 0;
+			m_stack[m_stack.size() - 2] = arith::eq(m_stack.back(), m_stack[m_stack.size() - 2]) ? 1 : 0;
 			m_stack.pop_back();
 			break;
 		case Instruction::ISZERO:
 			m_stack.back() = m_stack.back() ? 0 : 1;
 			break;
 		case Instruction::AND:
-			m_stack[m_stack.size() - 2] = m_stack.back() & m_stack[m_stack.size() - 2];
+			arith::bitAnd(m_stack.back(), m_stack[m_stack.size() - 2], m_stack[m_stack.size() - 2]);
 			m_stack.pop_back();
 			break;
 		case Instruction::OR:
-			m_stack[m_stack.size() - 2] = m_stack.back() | m_stack[m_stack.size() - 2];
+			arith::bitOr(m_stack.back(), m_stack[m_stack.size() - 2], m_stack[m_stack.size() - 2]);
 			m_stack.pop_back();
 			break;
 		case Instruction::XOR:
@@ -609,11 +646,8 @@ inline bytesConstRef VM::go(ExtVMFace& _ext, OnOpFunc const& _onOp, uint64_t _st
 		case Instruction::PUSH31:
 		case Instruction::PUSH32:
 		{
-			int i = (int)inst - (int)Instruction::PUSH1 + 1;
-			nextPC = m_curPC + 1;
-			m_stack.push_back(0);
-			for (; i--; nextPC++)
-				m_stack.back() = (m_stack.back() << 8) | _ext.getCode(nextPC);
+			m_stack.push_back(m_code->push(m_curPC));
+			nextPC = m_curPC + 1 + (int)inst - (int)Instruction::PUSH1 + 1;
 			break;
 		}
 		case Instruction::POP:
@@ -691,17 +725,17 @@ inline bytesConstRef VM::go(ExtVMFace& _ext, OnOpFunc const& _onOp, uint64_t _st
 			m_stack.pop_back();
 			break;
 		case Instruction::JUMP:
-			nextPC = m_stack.back();
-			if (!m_jumpDests.count(nextPC))
+			if (!m_code->isJumpDest(m_stack.back()))
 				BOOST_THROW_EXCEPTION(BadJumpDestination());
+			nextPC = (uint64_t)m_stack.back();
 			m_stack.pop_back();
 			break;
 		case Instruction::JUMPI:
 			if (m_stack[m_stack.size() - 2])
 			{
-				nextPC = m_stack.back();
-				if (!m_jumpDests.count(nextPC))
+				if (!m_code->isJumpDest(m_stack.back()))
 					BOOST_THROW_EXCEPTION(BadJumpDestination());
+				nextPC = (uint64_t)m_stack.back();
 			}
 			m_stack.pop_back();
 			m_stack.pop_back();
@@ -42,7 +42,7 @@ Host::Host(std::string const& _clientVersion, NetworkPreferences const& _n, bool
 	m_clientVersion(_clientVersion),
 	m_netPrefs(_n),
 	m_ifAddresses(Network::getInterfaceAddresses()),
-	m_ioService(2),
+	m_ioService(max(1u, _n.ioThreads)),
 	m_acceptorV4(m_ioService),
 	m_key(KeyPair::create())
 {
@@ -91,6 +91,11 @@ void Host::stop()
 
 void Host::doneWorking()
 {
+	// the other I/O threads finish as soon as run() stopped the ioservice
+	for (auto& t: m_ioThreads)
+		t.join();
+	m_ioThreads.clear();
+
 	// reset ioservice (allows manually polling network, below)
 	m_ioService.reset();
 	
@@ -457,6 +462,7 @@ void Host::connect(std::shared_ptr<Node> const& _n)
 				clog(NetConnect) << "Connection refused to node" << _n->id.abridged() << "@" << _n->address << "(" << ec.message() << ")";
 				_n->lastDisconnect = TCPError;
 				_n->lastAttempted = std::chrono::system_clock::now();
+				RecursiveGuard l(x_peers);
 				m_ready += _n->index;
 			}
 			else
@@ -539,7 +545,7 @@ void Host::growPeers()
 		else
 			for (auto const& i: m_peers)
 				if (auto p = i.second.lock())
-					p->ensureNodesRequested();
+					p->m_strand.dispatch([=](){ p->ensureNodesRequested(); });
 	}
 }
 
@@ -567,7 +573,7 @@ void Host::prunePeers()
 			if (!worst || agedPeers <= m_idealPeerCount)
 				break;
 			dc.insert(worst->id());
-			worst->disconnect(TooManyPeers);
+			worst->m_strand.dispatch([=](){ worst->disconnect(TooManyPeers); });
 		}
 
 	// Remove dead peers from list.
@@ -620,19 +626,23 @@ void Host::run(boost::system::error_code const&)
 	
 	if (m_hadNewNodes)
 	{
+		RecursiveGuard l(x_peers);
 		for (auto p: m_peers)
 			if (auto pp = p.second.lock())
-				pp->serviceNodesRequest();
+				pp->m_strand.dispatch([=](){ pp->serviceNodesRequest(); });
 		
 		m_hadNewNodes = false;
 	}
 	
 	if (chrono::steady_clock::now() - m_lastPing > chrono::seconds(30))	// ping every 30s.
 	{
-		for (auto p: m_peers)
-			if (auto pp = p.second.lock())
-				if (chrono::steady_clock::now() - pp->m_lastReceived > chrono::seconds(60))
-					pp->disconnect(PingTimeout);
+		{
+			RecursiveGuard l(x_peers);
+			for (auto p: m_peers)
+				if (auto pp = p.second.lock())
+					if (chrono::steady_clock::now() - pp->m_lastReceived > chrono::seconds(60))
+						pp->m_strand.dispatch([=](){ pp->disconnect(PingTimeout); });
+		}
 		pingAll();
 	}
 	
@@ -680,6 +690,14 @@ void Host::startedWorking()
 	clog(NetNote) << "Id:" << id().abridged();
 	
 	run(boost::system::error_code());
+
+	// the worker thread runs the ioservice too, in doWork()
+	for (unsigned i = 1; i < m_netPrefs.ioThreads; ++i)
+		m_ioThreads.push_back(thread([=]()
+		{
+			setThreadName("p2p.io");
+			m_ioService.run();
+		}));
 }
 
 void Host::doWork()
@@ -219,6 +219,7 @@ private:
 	int m_listenPort = -1;												///< What port are we listening on. -1 means binding failed or acceptor hasn't been initialized.
 
 	ba::io_service m_ioService;							///< IOService for network stuff.
+	std::vector<std::thread> m_ioThreads;					///< Threads running m_ioService alongside the worker; m_netPrefs.ioThreads - 1 of them.
 	bi::tcp::acceptor m_acceptorV4;							///< Listening acceptor.
 	std::unique_ptr<bi::tcp::socket> m_socket;								///< Listening socket.
 	
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <libdevcore/Guards.h>
 #include "Common.h"
 
 namespace dev
@@ -58,6 +59,8 @@ protected:
 
 	void seal(bytes& _b);
 
+	Mutex x_interpret;			///< Held while any of our peers interprets a packet, so host-wide state sees one at a time.
+
 private:
 	Host* m_host = nullptr;
 };
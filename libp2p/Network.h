@@ -40,6 +40,7 @@ struct NetworkPreferences
 	std::string publicIP;
 	bool upnp = true;
 	bool localNetworking = false;
+	unsigned ioThreads = 1;		///< Threads running the network I/O. Each peer's packets are still handled one at a time, in order.
 };
 
 /**
@@ -36,9 +36,16 @@ using namespace dev::p2p;
 #endif
 #define clogS(X) dev::LogOutputStream<X, true>(false) << "| " << std::setw(2) << m_socket.native_handle() << "] "
 
+/// The least free space given to each read from the socket.
+static const size_t c_readSize = 65536;
+
+/// Largest frame payload we'll accept from a peer; anything claiming to be bigger is a protocol violation.
+static const size_t c_maxFrameSize = 16 * 1024 * 1024;
+
 Session::Session(Host* _s, bi::tcp::socket _socket, bi::tcp::endpoint const& _manual):
 	m_server(_s),
 	m_socket(std::move(_socket)),
+	m_strand(_s->m_ioService),
 	m_node(nullptr),
 	m_manualEndpoint(_manual)	// NOTE: the port on this shouldn't be used if it's zero.
 {
@@ -50,6 +57,7 @@ Session::Session(Host* _s, bi::tcp::socket _socket, bi::tcp::endpoint const& _ma
 Session::Session(Host* _s, bi::tcp::socket _socket, std::shared_ptr<Node> const& _n, bool _force):
 	m_server(_s),
 	m_socket(std::move(_socket)),
+	m_strand(_s->m_ioService),
 	m_node(_n),
 	m_manualEndpoint(_n->address),
 	m_force(_force)
@@ -63,7 +71,10 @@ Session::~Session()
 	if (m_node)
 	{
 		if (id() && !isPermanentProblem(m_node->lastDisconnect) && !m_node->dead)
+		{
+			RecursiveGuard l(m_server->x_peers);
 			m_server->m_ready += m_node->index;
+		}
 		else
 			m_node->lastConnected = m_node->lastAttempted - chrono::seconds(1);
 	}
@@ -292,8 +303,10 @@ bool Session::interpret(RLP const& _r)
 	case PeersPacket:
         clogS(NetTriviaSummary) << "Peers (" << dec << (_r.itemCount() - 1) << " entries)";
 		m_weRequestedNodes = false;
-		for (unsigned i = 1; i < _r.itemCount(); ++i)
+		// Items are visited in order, so _r[i] is cheap; only the count needs hoisting out of the loop.
+		for (unsigned i = 1, n = _r.itemCount(); i < n; ++i)
 		{
+			RecursiveGuard l(m_server->x_peers);
 			bi::address peerAddress;
 			if (_r[i][0].size() == 16)
 				peerAddress = bi::address_v6(_r[i][0].toHash<FixedHash<16>>().asArray());
@@ -369,8 +382,13 @@ bool Session::interpret(RLP const& _r)
 	{
 		auto id = _r[0].toInt<unsigned>();
 		for (auto const& i: m_capabilities)
-			if (i.second->m_enabled && id >= i.second->m_idOffset && id - i.second->m_idOffset < i.second->hostCapability()->messageCount() && i.second->interpret(id - i.second->m_idOffset, _r))
-				return true;
+			if (i.second->m_enabled && id >= i.second->m_idOffset && id - i.second->m_idOffset < i.second->hostCapability()->messageCount())
+			{
+				// Other peers' strands may be interpreting on other threads; capabilities expect one at a time.
+				Guard l(i.second->hostCapability()->x_interpret);
+				if (i.second->interpret(id - i.second->m_idOffset, _r))
+					return true;
+			}
 		return false;
 	}
 	}
@@ -443,19 +461,32 @@ void Session::send(bytes&& _msg)
 	bool doWrite = false;
 	{
 		Guard l(x_writeQueue);
-		m_writeQueue.push_back(_msg);
-		doWrite = (m_writeQueue.size() == 1);
+		m_writeQueue.push_back(move(_msg));
+		doWrite = m_writing.empty();
 	}
 
 	if (doWrite)
-		write();
+	{
+		auto self(shared_from_this());
+		m_strand.dispatch([this, self](){ write(); });
+	}
 }
 
 void Session::write()
 {
-	const bytes& bytes = m_writeQueue[0];
+	vector<ba::const_buffer> buffers;
+	{
+		Guard l(x_writeQueue);
+		if (!m_writing.empty() || m_writeQueue.empty())
+			return;
+		m_writing.swap(m_writeQueue);
+		buffers.reserve(m_writing.size());
+		for (auto const& b: m_writing)
+			buffers.push_back(ba::buffer(b));
+	}
+
 	auto self(shared_from_this());
-	ba::async_write(m_socket, ba::buffer(bytes), [this, self](boost::system::error_code ec, std::size_t /*length*/)
+	ba::async_write(m_socket, buffers, m_strand.wrap([this, self](boost::system::error_code ec, std::size_t /*length*/)
 	{
 		// must check queue, as write callback can occur following dropped()
 		if (ec)
@@ -464,15 +495,12 @@ void Session::write()
 			drop(TCPError);
 			return;
 		}
-		else
 		{
 			Guard l(x_writeQueue);
-			m_writeQueue.pop_front();
-			if (m_writeQueue.empty())
-				return;
+			m_writing.clear();
 		}
 		write();
-	});
+	}));
 }
 
 void Session::drop(DisconnectReason _reason)
@@ -517,16 +545,20 @@ void Session::disconnect(DisconnectReason _reason)
 
 void Session::start()
 {
-	RLPStream s;
-	prep(s, HelloPacket, 5)
-					<< m_server->protocolVersion()
-					<< m_server->m_clientVersion
-					<< m_server->caps()
-					<< m_server->m_public.port()
-					<< m_server->id();
-	sealAndSend(s);
-	ping();
-	doRead();
+	auto self(shared_from_this());
+	m_strand.dispatch([this, self]()
+	{
+		RLPStream s;
+		prep(s, HelloPacket, 5)
+						<< m_server->protocolVersion()
+						<< m_server->m_clientVersion
+						<< m_server->caps()
+						<< m_server->m_public.port()
+						<< m_server->id();
+		sealAndSend(s);
+		ping();
+		doRead();
+	});
 }
 
 void Session::doRead()
@@ -535,8 +567,12 @@ void Session::doRead()
 	if (m_dropped)
 		return;
 	
+	// Read in after whatever's left of a partial frame, leaving space for a good-sized read.
+	if (m_incoming.size() < m_incomingSize + c_readSize)
+		m_incoming.resize(m_incomingSize + c_readSize);
+
 	auto self(shared_from_this());
-	m_socket.async_read_some(boost::asio::buffer(m_data), [this,self](boost::system::error_code ec, std::size_t length)
+	m_socket.async_read_some(boost::asio::buffer(m_incoming.data() + m_incomingSize, m_incoming.size() - m_incomingSize), m_strand.wrap([this,self](boost::system::error_code ec, std::size_t length)
 	{
 		// If error is end of file, ignore
 		if (ec && ec.category() != boost::asio::error::get_misc_category() && ec.value() != boost::asio::error::eof)
@@ -553,28 +589,38 @@ void Session::doRead()
 		{
 			try
 			{
-				m_incoming.resize(m_incoming.size() + length);
-				memcpy(m_incoming.data() + m_incoming.size() - length, m_data.data(), length);
-				while (m_incoming.size() > 8)
+				m_incomingSize += length;
+
+				// Parse as many whole frames as we have where they lie, then move any partial one to the front.
+				size_t parsed = 0;
+				while (m_incomingSize - parsed > 8)
 				{
-					if (m_incoming[0] != 0x22 || m_incoming[1] != 0x40 || m_incoming[2] != 0x08 || m_incoming[3] != 0x91)
+					byte const* frame = m_incoming.data() + parsed;
+					if (frame[0] != 0x22 || frame[1] != 0x40 || frame[2] != 0x08 || frame[3] != 0x91)
 					{
-						clogS(NetWarn) << "INVALID SYNCHRONISATION TOKEN; expected = 22400891; received = " << toHex(bytesConstRef(m_incoming.data(), 4));
+						clogS(NetWarn) << "INVALID SYNCHRONISATION TOKEN; expected = 22400891; received = " << toHex(bytesConstRef(frame, 4));
 						disconnect(BadProtocol);
 						return;
 					}
 					else
 					{
-						uint32_t len = fromBigEndian<uint32_t>(bytesConstRef(m_incoming.data() + 4, 4));
-						uint32_t tlen = len + 8;
-						if (m_incoming.size() < tlen)
+						uint32_t len = fromBigEndian<uint32_t>(bytesConstRef(frame + 4, 4));
+						if (len > c_maxFrameSize)
+						{
+							clogS(NetWarn) << "OVERSIZE FRAME; claimed length = " << len;
+							disconnect(BadProtocol);
+							return;
+						}
+						size_t tlen = (size_t)len + 8;
+						// Wait for the rest; doRead() grows the buffer only as its bytes actually arrive.
+						if (m_incomingSize - parsed < tlen)
 							break;
 
 						// enough has come in.
-						auto data = bytesConstRef(m_incoming.data(), tlen);
+						auto data = bytesConstRef(frame, tlen);
 						if (!checkPacket(data))
 						{
-							cerr << "Received " << len << ": " << toHex(bytesConstRef(m_incoming.data() + 8, len)) << endl;
+							cerr << "Received " << len << ": " << toHex(bytesConstRef(frame + 8, len)) << endl;
 							clogS(NetWarn) << "INVALID MESSAGE RECEIVED";
 							disconnect(BadProtocol);
 							return;
@@ -590,10 +636,16 @@ void Session::doRead()
 								//return;
 							}
 						}
-						memmove(m_incoming.data(), m_incoming.data() + tlen, m_incoming.size() - tlen);
-						m_incoming.resize(m_incoming.size() - tlen);
+						parsed += tlen;
 					}
 				}
+				if (parsed)
+				{
+					memmove(m_incoming.data(), m_incoming.data() + parsed, m_incomingSize - parsed);
+					m_incomingSize -= parsed;
+				}
+				if (!m_incomingSize && m_incoming.size() > c_readSize * 4)
+					bytes(c_readSize).swap(m_incoming);	// Done with an outsize frame; give the memory back.
 				doRead();
 			}
 			catch (Exception const& _e)
@@ -607,5 +659,5 @@ void Session::doRead()
 				drop(BadProtocol);
 			}
 		}
-	});
+	}));
 }
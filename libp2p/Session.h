@@ -93,7 +93,8 @@ private:
 	/// Perform a read on the socket.
 	void doRead();
 
-	/// Perform a single round of the write operation. This could end up calling itself asynchronously.
+	/// Write out everything queued, as a single gathered write, unless a write is already under way. Once it's done,
+	/// this calls itself again to write whatever has been queued since.
 	void write();
 
 	/// Interpret an incoming message.
@@ -105,10 +106,12 @@ private:
 	Host* m_server;							///< The host that owns us. Never null.
 
 	mutable bi::tcp::socket m_socket;		///< Socket for the peer's connection. Mutable to ask for native_handle().
+	ba::io_service::strand m_strand;		///< Everything touching the socket or our state runs through this, so we see one handler at a time.
 	Mutex x_writeQueue;						///< Mutex for the write queue.
 	std::deque<bytes> m_writeQueue;			///< The write queue.
-	std::array<byte, 65536> m_data;			///< Data buffer for the write queue.
-	bytes m_incoming;						///< The incoming read queue of bytes.
+	std::deque<bytes> m_writing;			///< The packets of the write under way, if any.
+	bytes m_incoming;						///< Buffer for incoming bytes; frames are parsed from it in place.
+	size_t m_incomingSize = 0;				///< The number of bytes of m_incoming that have been read but not yet parsed.
 
 	PeerInfo m_info;						///< Dynamic information about this peer.
 
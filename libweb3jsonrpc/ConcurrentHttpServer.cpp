@@ -0,0 +1,273 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ConcurrentHttpServer.cpp
+ * @date 2014
+ */
+
+#include "ConcurrentHttpServer.h"
+
+#include <chrono>
+#include <boost/algorithm/string.hpp>
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/Log.h>
+using namespace std;
+using namespace dev;
+using namespace jsonrpc;
+namespace ba = boost::asio;
+namespace bi = ba::ip;
+
+namespace
+{
+
+/// Largest request body we'll accept.
+static const size_t c_maxBody = 16 * 1024 * 1024;
+
+/// Largest request header we'll accept.
+static const size_t c_maxHeader = 8 * 1024;
+
+string errorResponse(int _code, char const* _message)
+{
+	return string("{\"jsonrpc\":\"2.0\",\"error\":{\"code\":") + toString(_code) + ",\"message\":\"" + _message + "\"},\"id\":null}";
+}
+
+}
+
+/// A single client connection; reads requests one after another (keeping the connection alive as HTTP/1.1 allows)
+/// and writes each response before reading the next.
+class ConcurrentHttpServer::Connection: public std::enable_shared_from_this<Connection>
+{
+public:
+	Connection(ConcurrentHttpServer& _server): m_server(_server), m_socket(_server.m_ioService), m_in(c_maxHeader + c_maxBody) {}
+
+	bi::tcp::socket& socket() { return m_socket; }
+
+	void readHeader()
+	{
+		auto self = shared_from_this();
+		ba::async_read_until(m_socket, m_in, "\r\n\r\n", [this, self](boost::system::error_code _ec, size_t _n)
+		{
+			// The buffer filled up without the header ending (or it ended too late); refuse it.
+			if (_ec == ba::error::not_found || (!_ec && _n > c_maxHeader))
+			{
+				m_keepAlive = false;
+				respond("431 Request Header Fields Too Large", string());
+				return;
+			}
+			if (_ec)
+				return;
+
+			string header(ba::buffers_begin(m_in.data()), ba::buffers_begin(m_in.data()) + _n);
+			m_in.consume(_n);
+
+			vector<string> lines;
+			boost::split(lines, header, boost::is_any_of("\r\n"), boost::token_compress_on);
+			vector<string> requestLine;
+			boost::split(requestLine, lines[0], boost::is_any_of(" "), boost::token_compress_on);
+			string method = requestLine[0];
+			bool http11 = requestLine.size() > 2 && requestLine[2] == "HTTP/1.1";
+
+			size_t length = 0;
+			string connection;
+			for (unsigned i = 1; i < lines.size(); ++i)
+			{
+				auto colon = lines[i].find(':');
+				if (colon == string::npos)
+					continue;
+				string name = boost::to_lower_copy(boost::trim_copy(lines[i].substr(0, colon)));
+				string value = boost::trim_copy(lines[i].substr(colon + 1));
+				if (name == "content-length")
+					length = strtoull(value.c_str(), nullptr, 10);
+				else if (name == "connection")
+					connection = boost::to_lower_copy(value);
+			}
+			m_keepAlive = http11 ? connection != "close" : connection == "keep-alive";
+
+			if (method == "OPTIONS")
+				respond("200 OK", string());
+			else if (method != "POST")
+			{
+				m_keepAlive = false;
+				respond("405 Method Not Allowed", string());
+			}
+			else if (length > c_maxBody)
+			{
+				m_keepAlive = false;
+				respond("413 Request Entity Too Large", string());
+			}
+			else
+				readBody(length);
+		});
+	}
+
+private:
+	void readBody(size_t _length)
+	{
+		if (m_in.size() >= _length)
+		{
+			string body(ba::buffers_begin(m_in.data()), ba::buffers_begin(m_in.data()) + _length);
+			m_in.consume(_length);
+			respond("200 OK", m_server.process(body));
+			return;
+		}
+		auto self = shared_from_this();
+		ba::async_read(m_socket, m_in, ba::transfer_exactly(_length - m_in.size()), [this, self, _length](boost::system::error_code _ec, size_t)
+		{
+			if (!_ec)
+				readBody(_length);
+		});
+	}
+
+	void respond(char const* _status, string const& _body)
+	{
+		m_out = string("HTTP/1.1 ") + _status + "\r\n"
+			"Content-Type: application/json\r\n"
+			"Content-Length: " + toString(_body.size()) + "\r\n"
+			"Access-Control-Allow-Origin: *\r\n"
+			"Access-Control-Allow-Headers: Content-Type\r\n" +
+			(m_keepAlive ? "" : "Connection: close\r\n") +
+			"\r\n" + _body;
+		auto self = shared_from_this();
+		ba::async_write(m_socket, ba::buffer(m_out), [this, self](boost::system::error_code _ec, size_t)
+		{
+			if (!_ec && m_keepAlive)
+				readHeader();
+			else
+			{
+				boost::system::error_code ec;
+				m_socket.shutdown(bi::tcp::socket::shutdown_both, ec);
+				m_socket.close(ec);
+			}
+		});
+	}
+
+	ConcurrentHttpServer& m_server;
+	bi::tcp::socket m_socket;
+	ba::streambuf m_in;
+	string m_out;
+	bool m_keepAlive = false;
+};
+
+ConcurrentHttpServer::ConcurrentHttpServer(int _port, unsigned _threads):
+	m_port(_port),
+	m_threads(max(1u, _threads))
+{
+}
+
+ConcurrentHttpServer::~ConcurrentHttpServer()
+{
+	StopListening();
+}
+
+bool ConcurrentHttpServer::StartListening()
+{
+	if (m_acceptor)
+		return true;
+	try
+	{
+		m_acceptor.reset(new bi::tcp::acceptor(m_ioService, bi::tcp::endpoint(bi::tcp::v4(), (unsigned short)m_port)));
+	}
+	catch (exception const& _e)
+	{
+		cwarn << "Couldn't start JSON-RPC server on port" << m_port << ":" << _e.what();
+		m_acceptor.reset();
+		return false;
+	}
+	accept();
+	for (unsigned i = 0; i < m_threads; ++i)
+		m_pool.push_back(thread([this]()
+		{
+			setThreadName("rpc");
+			m_ioService.run();
+		}));
+	return true;
+}
+
+bool ConcurrentHttpServer::StopListening()
+{
+	if (!m_acceptor)
+		return true;
+	m_ioService.stop();
+	for (auto& t: m_pool)
+		t.join();
+	m_pool.clear();
+	m_acceptor.reset();
+	m_ioService.reset();
+	return true;
+}
+
+void ConcurrentHttpServer::accept()
+{
+	auto c = make_shared<Connection>(*this);
+	m_acceptor->async_accept(c->socket(), [this, c](boost::system::error_code _ec)
+	{
+		if (_ec == ba::error::operation_aborted)
+			return;
+		if (!_ec)
+			c->readHeader();
+		accept();
+	});
+}
+
+bool ConcurrentHttpServer::SendResponse(string const& _response, void* _addInfo)
+{
+	*(string*)_addInfo = _response;
+	return true;
+}
+
+string ConcurrentHttpServer::process(string const& _request)
+{
+	Json::Value request;
+	if (!Json::Reader().parse(_request, request, false))
+		return errorResponse(-32700, "Parse error");
+	if (!request.isArray())
+		return processOne(_request, request);
+	if (request.empty())
+		return errorResponse(-32600, "Invalid Request");
+
+	string ret;
+	for (auto const& r: request)
+	{
+		string response = processOne(Json::FastWriter().write(r), r);
+		if (!response.empty())
+			ret += (ret.empty() ? "[" : ",") + response;
+	}
+	return ret.empty() ? ret : ret + "]";
+}
+
+string ConcurrentHttpServer::processOne(string const& _json, Json::Value const& _request)
+{
+	string method = _request.isObject() && _request["method"].isString() ? _request["method"].asString() : string();
+	string response;
+
+	auto start = chrono::steady_clock::now();
+	if (m_isConcurrent && m_isConcurrent(method))
+	{
+		ReadGuard l(x_calls);
+		OnRequest(_json, &response);
+	}
+	else
+	{
+		WriteGuard l(x_calls);
+		OnRequest(_json, &response);
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	Json::Value r;
+	bool failed = !response.empty() && Json::Reader().parse(response, r, false) && r.isObject() && r.isMember("error");
+	m_stats.record(method.empty() ? "(invalid)" : method, seconds, failed);
+	return response;
+}
@@ -0,0 +1,83 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ConcurrentHttpServer.h
+ * @date 2014
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <jsonrpccpp/server.h>
+#include "RpcStats.h"
+
+namespace jsonrpc
+{
+
+/**
+ * @brief An HTTP connector for JSON-RPC which serves requests on a pool of threads and accepts batches of them.
+ *
+ * Each request, or each member of a batch in turn, is handled on the pool thread that read it. Methods for which
+ * the concurrency predicate holds run alongside one another; any other method runs with nothing else running.
+ * Every call is timed and counted in stats(). Responses carry the same CORS headers as CorsHttpServer's.
+ */
+class ConcurrentHttpServer: public AbstractServerConnector
+{
+public:
+	ConcurrentHttpServer(int _port, unsigned _threads);
+	virtual ~ConcurrentHttpServer();
+
+	virtual bool StartListening();
+	virtual bool StopListening();
+	virtual bool SendResponse(std::string const& _response, void* _addInfo = NULL);
+
+	/// Set which methods may run concurrently with each other; by default none may.
+	void setConcurrent(std::function<bool(std::string const&)> const& _isConcurrent) { m_isConcurrent = _isConcurrent; }
+
+	/// @returns the counts and latencies of the calls served so far.
+	dev::RpcStats& stats() { return m_stats; }
+
+	/// Handle the JSON-RPC request, or batch of them, @a _request.
+	/// @returns the response, or the batch of responses; empty if none is due (i.e. all were notifications).
+	std::string process(std::string const& _request);
+
+private:
+	class Connection;
+
+	/// Handle the single request @a _request, whose JSON is @a _json.
+	std::string processOne(std::string const& _json, Json::Value const& _request);
+
+	void accept();
+
+	int m_port;
+	unsigned m_threads;
+
+	boost::asio::io_service m_ioService;
+	std::unique_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
+	std::vector<std::thread> m_pool;
+
+	std::function<bool(std::string const&)> m_isConcurrent;
+	boost::shared_mutex x_calls;		///< Held shared by concurrent calls and exclusively by all others.
+	dev::RpcStats m_stats;
+};
+
+}
@@ -0,0 +1,53 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file RpcStats.cpp
+ * @date 2014
+ */
+
+#include "RpcStats.h"
+
+#include <algorithm>
+using namespace std;
+using namespace dev;
+
+namespace
+{
+
+/// Upper bounds of all buckets but the last, in milliseconds.
+static const double c_bucketBounds[RpcStats::BucketCount - 1] = { 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 1000 };
+
+}
+
+double RpcStats::bucketBound(unsigned _i)
+{
+	return _i < BucketCount - 1 ? c_bucketBounds[_i] : 0;
+}
+
+void RpcStats::record(string const& _method, double _seconds, bool _failed)
+{
+	double ms = _seconds * 1000;
+	unsigned bucket = lower_bound(begin(c_bucketBounds), end(c_bucketBounds), ms) - begin(c_bucketBounds);
+
+	Guard l(x_methods);
+	Method& m = m_methods[_method];
+	++m.calls;
+	if (_failed)
+		++m.errors;
+	m.totalMs += ms;
+	m.maxMs = max(m.maxMs, ms);
+	++m.histogram[bucket];
+}
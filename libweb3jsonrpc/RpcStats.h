@@ -0,0 +1,66 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file RpcStats.h
+ * @date 2014
+ */
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <libdevcore/Common.h>
+#include <libdevcore/Guards.h>
+
+namespace dev
+{
+
+/**
+ * @brief Counts and latency histograms of the calls to each method of a JSON-RPC server. Thread-safe.
+ */
+class RpcStats
+{
+public:
+	/// Number of latency buckets; the last takes every call slower than the bound of the one before.
+	static const unsigned BucketCount = 12;
+
+	/// @returns the upper bound, in milliseconds, of latency bucket @a _i; 0 for the last, which is unbounded.
+	static double bucketBound(unsigned _i);
+
+	struct Method
+	{
+		uint64_t calls = 0;
+		uint64_t errors = 0;						///< Calls whose response was an error.
+		double totalMs = 0;
+		double maxMs = 0;
+		std::array<uint64_t, BucketCount> histogram = {{}};	///< Number of calls falling into each bucket.
+	};
+
+	/// Note a call to @a _method taking @a _seconds, whose response was an error if @a _failed.
+	void record(std::string const& _method, double _seconds, bool _failed);
+
+	/// @returns the stats so far of each method called.
+	std::map<std::string, Method> methods() const { Guard l(x_methods); return m_methods; }
+
+	void clear() { Guard l(x_methods); m_methods.clear(); }
+
+private:
+	mutable Mutex x_methods;
+	std::map<std::string, Method> m_methods;
+};
+
+}
@@ -25,6 +25,7 @@
 #include <libsolidity/Scanner.h>
 #include <libsolidity/SourceReferenceFormatter.h>
 #include "WebThreeStubServer.h"
+#include "ConcurrentHttpServer.h"
 #include <libevmcore/Instruction.h>
 #include <liblll/Compiler.h>
 #include <libethereum/Client.h>
@@ -192,6 +193,25 @@ static pair<shh::TopicMask, Public> toWatch(Json::Value const& _json)
 	return make_pair(bt.toTopicMask(), to);
 }
 
+static Json::Value toJson(RpcStats::Method const& _m)
+{
+	Json::Value res;
+	res["calls"] = (double)_m.calls;
+	res["errors"] = (double)_m.errors;
+	res["totalMs"] = _m.totalMs;
+	res["maxMs"] = _m.maxMs;
+	Json::Value histogram(Json::arrayValue);
+	for (unsigned i = 0; i < RpcStats::BucketCount; ++i)
+	{
+		Json::Value bucket;
+		bucket["le"] = i + 1 < RpcStats::BucketCount ? Json::Value(RpcStats::bucketBound(i)) : Json::Value();
+		bucket["count"] = (double)_m.histogram[i];
+		histogram.append(bucket);
+	}
+	res["histogram"] = histogram;
+	return res;
+}
+
 static Json::Value toJson(h256 const& _h, shh::Envelope const& _e, shh::Message const& _m)
 {
 	Json::Value res;
@@ -212,6 +232,12 @@ WebThreeStubServer::WebThreeStubServer(jsonrpc::AbstractServerConnector& _conn,
 	AbstractWebThreeStubServer(_conn),
 	m_web3(_web3)
 {
+	// Served on a pool of threads, only our read-only methods may run at once; the connector keeps the stats.
+	if (auto c = dynamic_cast<jsonrpc::ConcurrentHttpServer*>(&_conn))
+	{
+		c->setConcurrent(&WebThreeStubServer::isReadOnly);
+		m_stats = &c->stats();
+	}
 	setAccounts(_accounts);
 	auto path = getDataDir() + "/.web3";
 	boost::filesystem::create_directories(path);
@@ -336,13 +362,12 @@ std::string WebThreeStubServer::eth_call(Json::Value const& _json)
 				b = a.first;
 		t.from = b;
 	}
-	if (!m_accounts.count(t.from))
-		return ret;
 	if (!t.gasPrice)
 		t.gasPrice = 10 * dev::eth::szabo;
+	// Nothing is signed or paid for, so the sender needn't be one of ours nor able to afford the gas.
 	if (!t.gas)
-		t.gas = min<u256>(client()->gasLimitRemaining(), client()->balanceAt(t.from) / t.gasPrice);
-	ret = toJS(client()->call(m_accounts[t.from].secret(), t.value, t.to, t.data, t.gas, t.gasPrice));
+		t.gas = client()->gasLimitRemaining();
+	ret = toJS(client()->call(t.from, t.value, t.to, t.data, t.gas, t.gasPrice).output);
 	return ret;
 }
 
@@ -394,6 +419,27 @@ Json::Value WebThreeStubServer::eth_logs(Json::Value const& _json)
 	return toJson(client()->logs(toLogFilter(_json)));
 }
 
+Json::Value WebThreeStubServer::eth_rpcStats()
+{
+	Json::Value res(Json::objectValue);
+	if (m_stats)
+		for (auto const& i: m_stats->methods())
+			res[i.first] = toJson(i.second);
+	return res;
+}
+
+bool WebThreeStubServer::isReadOnly(std::string const& _method)
+{
+	static const set<string> s_readOnly = {
+		"web3_sha3", "eth_coinbase", "eth_listening", "eth_mining", "eth_gasPrice", "eth_accounts", "eth_peerCount",
+		"eth_defaultBlock", "eth_number", "eth_balanceAt", "eth_stateAt", "eth_storageAt", "eth_countAt", "eth_codeAt",
+		"eth_call", "eth_blockByHash", "eth_blockByNumber", "eth_transactionByHash", "eth_transactionByNumber",
+		"eth_uncleByHash", "eth_uncleByNumber", "eth_compilers", "eth_logs", "eth_rpcStats", "db_get", "db_getString",
+		"shh_haveIdentity"
+	};
+	return s_readOnly.count(_method);
+}
+
 std::string WebThreeStubServer::db_getString(std::string const& _name, std::string const& _key)
 {
 	bytes k = sha3(_name).asBytes() + sha3(_key).asBytes();
@@ -41,6 +41,7 @@ namespace ldb = leveldb;
 namespace dev
 {
 class WebThreeDirect;
+class RpcStats;
 class KeyPair;
 namespace eth
 {
@@ -79,6 +80,7 @@ public:
 	virtual std::string eth_gasPrice();
 	virtual Json::Value eth_filterLogs(int const& _id);
 	virtual Json::Value eth_logs(Json::Value const& _json);
+	virtual Json::Value eth_rpcStats();
 	virtual bool eth_listening();
 	virtual bool eth_mining();
 	virtual int eth_newFilter(Json::Value const& _json);
@@ -119,6 +121,9 @@ public:
 	void setIdentities(std::vector<dev::KeyPair> const& _ids);
 	std::map<dev::Public, dev::Secret> const& ids() const { return m_ids; }
 
+	/// @returns true if @a _method only reads, and so may be run alongside any other such calls.
+	static bool isReadOnly(std::string const& _method);
+
 private:
 	dev::eth::Interface* client() const;
 	std::shared_ptr<dev::shh::Interface> face() const;
@@ -131,4 +136,6 @@ private:
 	
 	std::map<dev::Public, dev::Secret> m_ids;
 	std::map<unsigned, dev::Public> m_shhWatches;
+
+	dev::RpcStats const* m_stats = nullptr;	///< The stats kept by our connector, if it's a ConcurrentHttpServer.
 };
@@ -21,6 +21,7 @@
 
 #include "Common.h"
 
+#include <algorithm>
 #include <libdevcrypto/SHA3.h>
 #include "Message.h"
 using namespace std;
@@ -70,6 +71,19 @@ bool TopicFilter::matches(Envelope const& _e) const
 	return false;
 }
 
+Topic TopicFilter::exactTopics() const
+{
+	Topic ret;
+	for (TopicMask const& t: m_topicMasks)
+	{
+		auto it = find_if(t.begin(), t.end(), [](pair<TopicPart, TopicPart> const& p) { return p.second == ~TopicPart(); });
+		if (it == t.end())
+			return Topic();
+		ret.push_back(it->first);
+	}
+	return ret;
+}
+
 TopicMask BuildTopicMask::toTopicMask() const
 {
 	TopicMask ret;
@@ -107,6 +107,10 @@ public:
 
 	bool matches(Envelope const& _m) const;
 
+	/// @returns, for each of our masks, a topic which an envelope must carry for that mask to match it; empty if any
+	/// mask has no part which must match exactly, and so may match envelopes whatever their topics.
+	Topic exactTopics() const;
+
 private:
 	TopicMasks m_topicMasks;
 };
@@ -34,7 +34,11 @@ using namespace dev::shh;
 #endif
 #define clogS(X) dev::LogOutputStream<X, true>(false) << "| " << std::setw(2) << session()->socketId() << "] "
 
-WhisperHost::WhisperHost()
+/// Longest we go without passing on messages and expiring old ones; inject() cuts it short.
+static const unsigned c_idleWaitMs = 1000;
+
+WhisperHost::WhisperHost():
+	Worker("shh", c_idleWaitMs)
 {
 }
 
@@ -74,9 +78,18 @@ void WhisperHost::inject(Envelope const& _m, WhisperPeer* _p)
 //	if (_p)
 	{
 		Guard l(m_filterLock);
-		for (auto const& f: m_filters)
-			if (f.second.filter.matches(_m))
-				noteChanged(h, f.first);
+		// Only filters indexed under one of the envelope's topics, or not indexed at all, can match it.
+		h256Set tried;
+		auto tryFilter = [&](h256 const& _f)
+		{
+			if (tried.insert(_f).second && m_filters.at(_f).filter.matches(_m))
+				noteChanged(h, _f);
+		};
+		for (auto const& t: _m.topics())
+			for (auto r = m_topicIndex.equal_range(t); r.first != r.second; ++r.first)
+				tryFilter(r.first->second);
+		for (auto const& f: m_unindexedFilters)
+			tryFilter(f);
 	}
 
 	for (auto& i: peers())
@@ -84,36 +97,75 @@ void WhisperHost::inject(Envelope const& _m, WhisperPeer* _p)
 			i->addRating(1);
 		else
 			i->cap<WhisperPeer>()->noteNewMessage(h, _m);
+
+	// Get it sent on its way now rather than at the next tick.
+	wake();
 }
 
 void WhisperHost::noteChanged(h256 _messageHash, h256 _filter)
 {
-	for (auto& i: m_watches)
-		if (i.second.id == _filter)
-		{
-			cwatshh << "!!!" << i.first << i.second.id;
-			i.second.changes.push_back(_messageHash);
-		}
+	for (auto r = m_filterWatches.equal_range(_filter); r.first != r.second; ++r.first)
+	{
+		cwatshh << "!!!" << r.first->second << _filter;
+		m_watches.at(r.first->second).changes.push_back(_messageHash);
+	}
 }
 
-unsigned WhisperHost::installWatchOnId(h256 _h)
+void WhisperHost::indexFilter(h256 _id, TopicFilter const& _f)
+{
+	Topic exact = _f.exactTopics();
+	if (exact.empty())
+		m_unindexedFilters.insert(_id);
+	else
+		for (auto const& t: exact)
+			m_topicIndex.insert(make_pair(t, _id));
+}
+
+void WhisperHost::unindexFilter(h256 _id, TopicFilter const& _f)
+{
+	m_unindexedFilters.erase(_id);
+	for (auto const& t: _f.exactTopics())
+		for (auto r = m_topicIndex.equal_range(t); r.first != r.second;)
+			if (r.first->second == _id)
+				r.first = m_topicIndex.erase(r.first);
+			else
+				++r.first;
+}
+
+unsigned WhisperHost::addWatch(h256 _h)
 {
 	auto ret = m_watches.size() ? m_watches.rbegin()->first + 1 : 0;
 	m_watches[ret] = ClientWatch(_h);
+	m_filterWatches.insert(make_pair(_h, ret));
 	cwatshh << "+++" << ret << _h;
 	return ret;
 }
 
+unsigned WhisperHost::installWatchOnId(h256 _h)
+{
+	Guard l(m_filterLock);
+	auto fit = m_filters.find(_h);
+	if (fit != m_filters.end())
+		++fit->second.refCount;
+	return addWatch(_h);
+}
+
 unsigned WhisperHost::installWatch(shh::TopicFilter const& _f)
 {
 	Guard l(m_filterLock);
 
 	h256 h = _f.sha3();
 
-	if (!m_filters.count(h))
+	auto fit = m_filters.find(h);
+	if (fit == m_filters.end())
+	{
 		m_filters.insert(make_pair(h, _f));
+		indexFilter(h, _f);
+	}
+	else
+		++fit->second.refCount;
 
-	return installWatchOnId(h);
+	return addWatch(h);
 }
 
 h256s WhisperHost::watchMessages(unsigned _watchId)
@@ -148,11 +200,20 @@ void WhisperHost::uninstallWatch(unsigned _i)
 		return;
 	auto id = it->second.id;
 	m_watches.erase(it);
+	for (auto r = m_filterWatches.equal_range(id); r.first != r.second; ++r.first)
+		if (r.first->second == _i)
+		{
+			m_filterWatches.erase(r.first);
+			break;
+		}
 
 	auto fit = m_filters.find(id);
 	if (fit != m_filters.end())
 		if (!--fit->second.refCount)
+		{
+			unindexFilter(id, fit->second.filter);
 			m_filters.erase(fit);
+		}
 }
 
 void WhisperHost::doWork()
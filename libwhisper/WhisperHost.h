@@ -25,6 +25,7 @@
 #include <array>
 #include <set>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <libdevcore/RLP.h>
 #include <libdevcore/Worker.h>
@@ -76,6 +77,14 @@ private:
 
 	void noteChanged(h256 _messageHash, h256 _filter);
 
+	/// Add a watch on the filter @a _filterId, returning its id; m_filterLock must be held.
+	unsigned addWatch(h256 _filterId);
+
+	/// Add the newly-installed filter @a _f, whose hash is @a _id, to m_topicIndex or m_unindexedFilters.
+	void indexFilter(h256 _id, TopicFilter const& _f);
+	/// Remove the filter @a _f, whose hash is @a _id, from m_topicIndex or m_unindexedFilters.
+	void unindexFilter(h256 _id, TopicFilter const& _f);
+
 	mutable dev::SharedMutex x_messages;
 	std::map<h256, Envelope> m_messages;
 	std::multimap<unsigned, h256> m_expiryQueue;
@@ -83,6 +92,9 @@ private:
 	mutable dev::Mutex m_filterLock;
 	std::map<h256, InstalledFilter> m_filters;
 	std::map<unsigned, ClientWatch> m_watches;
+	std::unordered_multimap<TopicPart, h256, TopicPart::hash> m_topicIndex;	///< Filters by a topic that each of their masks needs exactly.
+	h256Set m_unindexedFilters;						///< Filters with a mask needing no topic exactly; tried on every envelope.
+	std::multimap<h256, unsigned> m_filterWatches;	///< The watches on each filter.
 };
 
 }
@@ -32,6 +32,7 @@
 #if ETH_JSONRPC
 #include <libweb3jsonrpc/WebThreeStubServer.h>
 #include <libweb3jsonrpc/CorsHttpServer.h>
+#include <libweb3jsonrpc/ConcurrentHttpServer.h>
 #endif
 #include <libwebthree/WebThree.h>
 #include "BuildInfo.h"
@@ -68,10 +69,16 @@ void help()
         << "    -c,--client-name <name>  Add a name to your client's version string (default: blank)." << endl
         << "    -d,--db-path <path>  Load database from path (default:  ~/.ethereum " << endl
         << "                         <APPDATA>/Etherum or Library/Application Support/Ethereum)." << endl
+        << "    --db-cache <MB>  Size of the cache of each database (default: 32)." << endl
+        << "    --db-bloom-bits <bits>  Bits per key of each database's bloom filter; 0 for none (default: 10)." << endl
+        << "    --db-compression <on/off>  Compress the databases on disk (default: on)." << endl
+        << "    --db-max-open-files <number>  Most files each database keeps open (default: 500)." << endl
+        << "    --db-write-buffer <MB>  Size of the write buffer of each database (default: 4)." << endl
         << "    -h,--help  Show this help message and exit." << endl
 #if ETH_JSONRPC
         << "    -j,--json-rpc  Enable JSON-RPC server (default: off)." << endl
         << "    --json-rpc-port  Specify JSON-RPC server port (implies '-j', default: 8080)." << endl
+        << "    --json-rpc-threads <number>  Serve JSON-RPC (and batches of requests) on the given number of threads (default: 0, a single server)." << endl
 #endif
         << "    -l,--listen <port>  Listen on the given port for incoming connected (default: 30303)." << endl
         << "    -m,--mining <on/off>  Enable mining (default: off)" << endl
@@ -300,8 +307,10 @@ int main(int argc, char** argv)
 	string dbPath;
 	bool mining = false;
 	unsigned peers = 5;
+	DatabaseProfile dbProfile;
 #if ETH_JSONRPC
 	int jsonrpc = 8080;
+	unsigned jsonrpcThreads = 0;
 #endif
 	string publicIP;
 	bool upnp = true;
@@ -361,6 +370,27 @@ int main(int argc, char** argv)
 			us = KeyPair(h256(fromHex(argv[++i])));
 		else if ((arg == "-d" || arg == "--path" || arg == "--db-path") && i + 1 < argc)
 			dbPath = argv[++i];
+		else if (arg == "--db-cache" && i + 1 < argc)
+			dbProfile.cacheMB = atoi(argv[++i]);
+		else if (arg == "--db-bloom-bits" && i + 1 < argc)
+			dbProfile.bloomBits = atoi(argv[++i]);
+		else if (arg == "--db-write-buffer" && i + 1 < argc)
+			dbProfile.writeBufferMB = max(1, atoi(argv[++i]));
+		else if (arg == "--db-max-open-files" && i + 1 < argc)
+			dbProfile.maxOpenFiles = max(64, atoi(argv[++i]));
+		else if (arg == "--db-compression" && i + 1 < argc)
+		{
+			string m = argv[++i];
+			if (isTrue(m))
+				dbProfile.compression = true;
+			else if (isFalse(m))
+				dbProfile.compression = false;
+			else
+			{
+				cerr << "Invalid --db-compression option: " << m << endl;
+				return -1;
+			}
+		}
 		else if ((arg == "-m" || arg == "--mining") && i + 1 < argc)
 		{
 			string m = argv[++i];
@@ -378,6 +408,8 @@ int main(int argc, char** argv)
 			jsonrpc = jsonrpc ? jsonrpc : 8080;
 		else if (arg == "--json-rpc-port" && i + 1 < argc)
 			jsonrpc = atoi(argv[++i]);
+		else if (arg == "--json-rpc-threads" && i + 1 < argc)
+			jsonrpcThreads = max(0, atoi(argv[++i]));
 #endif
 		else if ((arg == "-v" || arg == "--verbosity") && i + 1 < argc)
 			g_logVerbosity = atoi(argv[++i]);
@@ -394,6 +426,7 @@ int main(int argc, char** argv)
 	if (!clientName.empty())
 		clientName += "/";
 
+	Defaults::setDatabaseProfile(dbProfile);
 	WebThreeDirect web3("NEthereum(++)/" + clientName + "v" + dev::Version + "/" DEV_QUOTED(ETH_BUILD_TYPE) "/" DEV_QUOTED(ETH_BUILD_PLATFORM), dbPath);
 	Client& c = *web3.ethereum();
 
@@ -476,7 +509,7 @@ int main(int argc, char** argv)
 	unique_ptr<jsonrpc::AbstractServerConnector> jsonrpcConnector;
 	if (jsonrpc > -1)
 	{
-		jsonrpcConnector = unique_ptr<jsonrpc::AbstractServerConnector>(new jsonrpc::HttpServer(jsonrpc));
+		jsonrpcConnector = unique_ptr<jsonrpc::AbstractServerConnector>(jsonrpcThreads ? (jsonrpc::AbstractServerConnector*)new jsonrpc::ConcurrentHttpServer(jsonrpc, jsonrpcThreads) : new jsonrpc::HttpServer(jsonrpc));
 		jsonrpcServer = shared_ptr<WebThreeStubServer>(new WebThreeStubServer(*jsonrpcConnector.get(), web3, vector<KeyPair>({us})));
 		jsonrpcServer->setIdentities({us});
 		jsonrpcServer->StartListening();
@@ -551,7 +584,7 @@ int main(int argc, char** argv)
 		{
 			if (jsonrpc < 0)
 				jsonrpc = 8080;
-			jsonrpcConnector = unique_ptr<jsonrpc::AbstractServerConnector>(new jsonrpc::HttpServer(jsonrpc));
+			jsonrpcConnector = unique_ptr<jsonrpc::AbstractServerConnector>(jsonrpcThreads ? (jsonrpc::AbstractServerConnector*)new jsonrpc::ConcurrentHttpServer(jsonrpc, jsonrpcThreads) : new jsonrpc::HttpServer(jsonrpc));
 			jsonrpcServer = shared_ptr<WebThreeStubServer>(new WebThreeStubServer(*jsonrpcConnector.get(), web3, vector<KeyPair>({us})));
 			jsonrpcServer->setIdentities({us});
 			jsonrpcServer->StartListening();
@@ -0,0 +1,114 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file arith256.cpp
+ * @date 2014
+ * Checks the limb-level word operations of libevm against the multiprecision operators they stand in for.
+ */
+
+#include <random>
+#include <boost/test/unit_test.hpp>
+#include <libevm/Arith256.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+
+u256 const c_max = ~u256(0);
+
+/// Words around each limb boundary and at either end of the range, where carries and borrows happen.
+vector<u256> edgeCases()
+{
+	vector<u256> ret = { 0, 1, 2, c_max, c_max - 1, c_max >> 1, (c_max >> 1) + 1 };
+	for (unsigned i = 64; i < 256; i += 64)
+	{
+		u256 p = u256(1) << i;
+		ret.push_back(p);
+		ret.push_back(p - 1);
+		ret.push_back(p + 1);
+		ret.push_back(c_max - p + 1);
+	}
+	return ret;
+}
+
+/// @returns a word of @a _limbs random limbs, so that short as well as full-length words turn up.
+u256 randomWord(mt19937_64& _r, unsigned _limbs)
+{
+	u256 ret;
+	for (unsigned i = 0; i < _limbs; ++i)
+		ret = (ret << 64) | _r();
+	return ret;
+}
+
+void checkAll(u256 const& _a, u256 const& _b)
+{
+	u256 r;
+	arith::add(_a, _b, r);
+	BOOST_CHECK_MESSAGE(r == u256(_a + _b), "add " << _a << " " << _b);
+	arith::sub(_a, _b, r);
+	BOOST_CHECK_MESSAGE(r == u256(_a - _b), "sub " << _a << " " << _b);
+	arith::mul(_a, _b, r);
+	BOOST_CHECK_MESSAGE(r == u256(_a * _b), "mul " << _a << " " << _b);
+	arith::bitAnd(_a, _b, r);
+	BOOST_CHECK_MESSAGE(r == (_a & _b), "and " << _a << " " << _b);
+	arith::bitOr(_a, _b, r);
+	BOOST_CHECK_MESSAGE(r == (_a | _b), "or " << _a << " " << _b);
+	BOOST_CHECK_MESSAGE(arith::lt(_a, _b) == (_a < _b), "lt " << _a << " " << _b);
+	BOOST_CHECK_MESSAGE(arith::eq(_a, _b) == (_a == _b), "eq " << _a << " " << _b);
+
+	// The result may be either operand.
+	r = _a;
+	arith::add(r, _b, r);
+	BOOST_CHECK(r == u256(_a + _b));
+	r = _b;
+	arith::sub(_a, r, r);
+	BOOST_CHECK(r == u256(_a - _b));
+	r = _a;
+	arith::mul(r, r, r);
+	BOOST_CHECK(r == u256(_a * _a));
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(Arith256Tests)
+
+BOOST_AUTO_TEST_CASE(arith256_edges)
+{
+	auto edges = edgeCases();
+	for (auto const& a: edges)
+		for (auto const& b: edges)
+			checkAll(a, b);
+
+	u256 r;
+	arith::add(c_max, 1, r);
+	BOOST_CHECK(r == 0);
+	arith::sub(0, 1, r);
+	BOOST_CHECK(r == c_max);
+	arith::mul(c_max, c_max, r);
+	BOOST_CHECK(r == 1);
+}
+
+BOOST_AUTO_TEST_CASE(arith256_random)
+{
+	mt19937_64 r(42);
+	for (unsigned i = 0; i < 20000; ++i)
+		checkAll(randomWord(r, 1 + i % 4), randomWord(r, 1 + (i / 4) % 4));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,51 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file client.cpp
+ * @date 2014
+ * Client tests.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <libp2p/Host.h>
+#include <libethereum/Client.h>
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+BOOST_AUTO_TEST_SUITE(ClientTests)
+
+BOOST_AUTO_TEST_CASE(client_call_from_fresh_address)
+{
+	p2p::Host host("Ethereum(++) tests");
+	Client c(&host, (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string(), true);
+
+	// A caller with no account at all, calling the identity precompiled contract.
+	Address from = KeyPair::create().address();
+	BOOST_REQUIRE(!c.balanceAt(from, 0) && !c.countAt(from, 0));
+	bytes data = { 1, 2, 3 };
+	ExecutionResult r = c.call(from, 0, Address(4), data, 100000, 0);
+	BOOST_CHECK(!r.excepted);
+	BOOST_CHECK(r.output == data);
+	BOOST_CHECK_EQUAL(r.gasUsed, (u256)Interface::txGas(data) + 2);
+
+	// It can't send value it hasn't got, and nothing it did stuck.
+	BOOST_CHECK(c.call(from, 1, Address(4), data, 100000, 0).excepted);
+	BOOST_CHECK(!c.balanceAt(from, 0) && !c.countAt(from, 0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
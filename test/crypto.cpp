@@ -461,6 +461,50 @@ BOOST_AUTO_TEST_CASE(eth_keypairs)
 	}
 
 } 
+
+BOOST_AUTO_TEST_CASE(eth_recoverSenders)
+{
+	vector<KeyPair> keys;
+	vector<bytes> rlps;
+	for (unsigned i = 0; i < 64; ++i)
+	{
+		keys.push_back(KeyPair::create());
+		rlps.push_back(eth::Transaction(i, 0, 0, keys.back().address(), bytes(), 0, keys.back().secret()).rlp());
+	}
+	rlps.push_back(bytes(1, 0x80));	// malformed; should just be skipped.
+
+	vector<bytesConstRef> refs;
+	for (auto const& r: rlps)
+		refs.push_back(&r);
+	eth::recoverSenders(refs);
+
+	for (unsigned i = 0; i < keys.size(); ++i)
+		BOOST_CHECK(eth::Transaction(rlps[i]).sender() == keys[i].address());
+}
+
+BOOST_AUTO_TEST_CASE(ecdsa_backends_agree)
+{
+	// dev::sign/recover/toPublic use whichever backend was built in; check them against the Crypto++ one directly.
+	for (unsigned i = 0; i < 32; ++i)
+	{
+		KeyPair k = KeyPair::create();
+		h256 hash = sha3(toString(i));
+
+		Public p;
+		s_secp256k1.toPublic(k.sec(), p);
+		BOOST_REQUIRE(p == k.pub());
+		BOOST_REQUIRE(toPublic(k.sec()) == k.pub());
+
+		Signature sig = sign(k.sec(), hash);
+		BOOST_REQUIRE(recover(sig, hash) == k.pub());
+		BOOST_REQUIRE(s_secp256k1.recover(sig, hash.ref()) == k.pub());
+		BOOST_REQUIRE(verify(k.pub(), sig, hash));
+
+		Signature cppSig = s_secp256k1.sign(k.sec(), hash);
+		BOOST_REQUIRE(recover(cppSig, hash) == k.pub());
+		BOOST_REQUIRE(!verify(k.pub(), cppSig, sha3(hash)));
+	}
+}
  
 
 int cryptoTest()
@@ -32,6 +32,7 @@
 #include <libwebthree/WebThree.h>
 #include <libweb3jsonrpc/WebThreeStubServer.h>
 #include <libweb3jsonrpc/CorsHttpServer.h>
+#include <libweb3jsonrpc/ConcurrentHttpServer.h>
 //#include <json/json.h>
 #include <jsonrpccpp/server/connectors/httpserver.h>
 #include <jsonrpccpp/client/connectors/httpclient.h>
@@ -312,6 +313,27 @@ BOOST_AUTO_TEST_CASE(contract_storage)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(jsonrpc_batch)
+{
+	cnote << "Testing jsonrpc batch...";
+	jsonrpc::ConcurrentHttpServer connector(8081, 2);
+	WebThreeStubServer server(connector, *web3, {});
+
+	Json::Value batch;
+	Json::Reader().parse(connector.process(
+		"[{\"jsonrpc\":\"2.0\",\"method\":\"eth_gasPrice\",\"params\":[],\"id\":1},"
+		"{\"jsonrpc\":\"2.0\",\"method\":\"eth_number\",\"params\":[],\"id\":2}]"), batch);
+	BOOST_REQUIRE(batch.isArray());
+	BOOST_CHECK_EQUAL(batch.size(), 2);
+	BOOST_CHECK_EQUAL(batch[0u]["result"].asString(), toJS(10 * dev::eth::szabo));
+	BOOST_CHECK_EQUAL(batch[1u]["result"].asInt(), (int)web3->ethereum()->number());
+
+	Json::Value stats = server.eth_rpcStats();
+	BOOST_CHECK_EQUAL(stats["eth_gasPrice"]["calls"].asInt(), 1);
+	BOOST_CHECK_EQUAL(stats["eth_number"]["calls"].asInt(), 1);
+	BOOST_CHECK_EQUAL(stats["eth_number"]["histogram"].size(), dev::RpcStats::BucketCount);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
 
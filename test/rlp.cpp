@@ -196,5 +196,23 @@ BOOST_AUTO_TEST_CASE(rlp_decoding_test)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(rlp_index_test)
+{
+	cnote << "Testing RLP index...";
+	RLPStream s(4);
+	s << "cat" << u256(1024);
+	s.appendList(2) << "dog" << bytes(100, 0xaa);
+	s << "";
+	bytes out = s.out();
+	RLP r(out);
+	RLPIndex index(r);
+	BOOST_REQUIRE_EQUAL(index.itemCount(), r.itemCount());
+	for (unsigned i = index.itemCount(); i--;)
+		BOOST_CHECK(index[i].data() == r[i].data());
+	BOOST_CHECK(index[4].isNull());
+	bytes notList = rlp("cat");
+	BOOST_CHECK_EQUAL(RLPIndex(RLP(notList)).itemCount(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
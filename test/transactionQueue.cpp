@@ -0,0 +1,108 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file transactionQueue.cpp
+ * @date 2014
+ * TransactionQueue tests.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <libdevcrypto/Common.h>
+#include <libdevcrypto/SHA3.h>
+#include <libethereum/Transaction.h>
+#include <libethereum/TransactionQueue.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+
+bytes makeTx(KeyPair const& _k, u256 _nonce, u256 _gasPrice)
+{
+	return Transaction(0, _gasPrice, 10000, Address(), bytes(), _nonce, _k.secret()).rlp();
+}
+
+h256s hashes(QueuedTransactions const& _ts)
+{
+	h256s ret;
+	for (auto const& i: _ts)
+		ret.push_back(i->hash);
+	return ret;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(TransactionQueueTests)
+
+BOOST_AUTO_TEST_CASE(tq_transactionsSince)
+{
+	KeyPair a = KeyPair::create();
+	KeyPair b = KeyPair::create();
+	bytes a0 = makeTx(a, 0, 10);
+	bytes a1 = makeTx(a, 1, 10);
+	bytes a2 = makeTx(a, 2, 10);
+	bytes b0 = makeTx(b, 0, 50);
+
+	TransactionQueue tq;
+	BOOST_REQUIRE(tq.import(&a1));
+	BOOST_REQUIRE(tq.import(&a0));
+	BOOST_REQUIRE(tq.import(&b0));
+	BOOST_CHECK(!tq.import(&a0));
+
+	// Best gas price first, each sender's in nonce order whatever order they arrived in.
+	unsigned watermark = 0;
+	BOOST_CHECK(hashes(tq.transactionsSince(watermark)) == h256s({ sha3(b0), sha3(a0), sha3(a1) }));
+	BOOST_CHECK(hashes(*tq.transactions()) == h256s({ sha3(b0), sha3(a0), sha3(a1) }));
+	unsigned w = watermark;
+	BOOST_CHECK(tq.transactionsSince(watermark).empty());
+	BOOST_CHECK_EQUAL(watermark, w);
+
+	// Set aside: no longer current, and nothing new since.
+	tq.setFuture(sha3(a1));
+	BOOST_CHECK(tq.transactionsSince(watermark).empty());
+	BOOST_CHECK(hashes(*tq.transactions()) == h256s({ sha3(b0), sha3(a0) }));
+	BOOST_CHECK(tq.items() == make_pair(2u, 1u));
+
+	// A good transaction from the sender makes it current again, under a new sequence number.
+	tq.noteGood(a.address());
+	BOOST_CHECK(hashes(tq.transactionsSince(watermark)) == h256s({ sha3(a1) }));
+	BOOST_CHECK(watermark > w);
+	BOOST_CHECK(tq.transactionsSince(watermark).empty());
+
+	// Dropping leaves nothing new.
+	tq.drop(sha3(b0));
+	BOOST_CHECK(tq.transactionsSince(watermark).empty());
+	BOOST_CHECK(hashes(*tq.transactions()) == h256s({ sha3(a0), sha3(a1) }));
+	BOOST_CHECK(tq.items() == make_pair(2u, 0u));
+
+	// A dropped future transaction isn't brought back by noteGood().
+	BOOST_REQUIRE(tq.import(&a2));
+	BOOST_CHECK(hashes(tq.transactionsSince(watermark)) == h256s({ sha3(a2) }));
+	tq.setFuture(sha3(a2));
+	tq.drop(sha3(a2));
+	tq.noteGood(a.address());
+	BOOST_CHECK(tq.transactionsSince(watermark).empty());
+	BOOST_CHECK(tq.items() == make_pair(2u, 0u));
+
+	// Starting again from zero gives all that are current.
+	unsigned fresh = 0;
+	BOOST_CHECK(hashes(tq.transactionsSince(fresh)) == h256s({ sha3(a0), sha3(a1) }));
+	BOOST_CHECK_EQUAL(fresh, watermark);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
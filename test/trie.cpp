@@ -25,6 +25,7 @@
 #include "JsonSpiritHeaders.h"
 #include <libdevcore/CommonIO.h>
 #include <libdevcrypto/TrieDB.h>
+#include <libdevcrypto/NodeCache.h>
 #include "TrieHash.h"
 #include "MemTrie.h"
 #include <boost/test/unit_test.hpp>
@@ -424,6 +425,51 @@ BOOST_AUTO_TEST_CASE(trieStess)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(memoryDBRefCounts)
+{
+	MemoryDB m;
+	bytes v = fromHex("0102");
+	h256 h = sha3(v);
+	m.insert(h, &v);
+	m.insert(h, &v);
+	BOOST_CHECK(m.exists(h));
+	BOOST_CHECK_EQUAL(m.lookup(h), asString(v));
+
+	m.kill(h);
+	BOOST_CHECK(m.keys().count(h));
+	m.kill(h);
+	BOOST_CHECK(!m.keys().count(h));
+
+	{
+		EnforceRefs r(m, true);
+		BOOST_CHECK(!m.exists(h));
+		BOOST_CHECK(m.lookup(h).empty());
+		BOOST_CHECK(m.get().empty());
+	}
+	BOOST_CHECK(m.exists(h));
+	m.purge();
+	BOOST_CHECK(!m.exists(h));
+}
+
+BOOST_AUTO_TEST_CASE(nodeCacheEviction)
+{
+	NodeCache c(8);
+	string v;
+	c.insert(sha3("a"), "aaaa");
+	c.insert(sha3("b"), "bbbb");
+	BOOST_CHECK(c.lookup(sha3("a"), v));
+	BOOST_CHECK_EQUAL(v, "aaaa");
+
+	// "b" is now the least recently used, so it's the one to go.
+	c.insert(sha3("c"), "cccc");
+	BOOST_CHECK(!c.lookup(sha3("b"), v));
+	BOOST_CHECK(c.lookup(sha3("a"), v));
+	BOOST_CHECK(c.lookup(sha3("c"), v));
+	BOOST_CHECK_EQUAL(c.size(), 8u);
+	BOOST_CHECK_EQUAL(c.hits(), 3u);
+	BOOST_CHECK_EQUAL(c.misses(), 1u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -457,6 +457,60 @@ void doVMTests(json_spirit::mValue& v, bool _fillin)
 	}
 }
 
+/// Run each test both with a trace, so gas is charged per instruction, and without one, so the VM charges it per
+/// straight-line run; check that both give the same output, gas left, exceptions and effects.
+void doVMUntracedTests(json_spirit::mValue& v)
+{
+	for (auto& i: v.get_obj())
+	{
+		cnote << i.first;
+		mObject& o = i.second.get_obj();
+
+		struct Run
+		{
+			FakeExtVM fev;
+			bytes output;
+			u256 gas;
+			bool excepted = false;
+		};
+		auto run = [&](bool _traced, Run& o_run)
+		{
+			o_run.fev.importEnv(o["env"].get_obj());
+			o_run.fev.importState(o["pre"].get_obj());
+			o_run.fev.importExec(o["exec"].get_obj());
+			if (o_run.fev.code.empty())
+			{
+				o_run.fev.thisTxCode = get<3>(o_run.fev.addresses.at(o_run.fev.myAddress));
+				o_run.fev.code = o_run.fev.thisTxCode;
+			}
+			try
+			{
+				auto vm = eth::VMFactory::create(o_run.fev.gas);
+				o_run.output = vm->go(o_run.fev, _traced ? o_run.fev.simpleTrace() : OnOpFunc()).toBytes();
+				o_run.gas = vm->gas();
+			}
+			catch (VMException const&)
+			{
+				o_run.excepted = true;
+			}
+		};
+
+		Run traced;
+		run(true, traced);
+		Run untraced;
+		run(false, untraced);
+
+		BOOST_CHECK_MESSAGE(traced.excepted == untraced.excepted, i.first << ": exception " << untraced.excepted << " untraced, " << traced.excepted << " traced");
+		if (traced.excepted || untraced.excepted)
+			continue;
+		BOOST_CHECK_MESSAGE(traced.gas == untraced.gas, i.first << ": gas left " << untraced.gas << " untraced, " << traced.gas << " traced");
+		BOOST_CHECK_MESSAGE(traced.output == untraced.output, i.first << ": output differs");
+		BOOST_CHECK_MESSAGE(traced.fev.addresses == untraced.fev.addresses, i.first << ": state differs");
+		BOOST_CHECK_MESSAGE(traced.fev.callcreates == untraced.fev.callcreates, i.first << ": callcreates differ");
+		checkLog(untraced.fev.sub.logs, traced.fev.sub.logs);
+	}
+}
+
 } } // Namespace Close
 
 BOOST_AUTO_TEST_SUITE(VMTests)
@@ -506,6 +560,31 @@ BOOST_AUTO_TEST_CASE(vmLogTest)
 	dev::test::executeTests("vmLogTest", "/VMTests", dev::test::doVMTests);
 }
 
+BOOST_AUTO_TEST_CASE(vmUntracedTest)
+{
+	string testPath = getTestPath() + "/VMTests/";
+	for (string name: { "vmtests", "vmArithmeticTest", "vmBitwiseLogicOperationTest", "vmSha3Test", "vmEnvironmentalInfoTest", "vmBlockInfoTest", "vmIOandFlowOperationsTest", "vmPushDupSwapTest", "vmLogTest" })
+	{
+		try
+		{
+			cnote << "Testing untraced ..." << name;
+			json_spirit::mValue v;
+			string s = asString(dev::contents(testPath + name + ".json"));
+			BOOST_REQUIRE_MESSAGE(s.length() > 0, "Contents of " + testPath + name + ".json is empty. Have you cloned the 'tests' repo branch develop and set ETHEREUM_TEST_PATH to its path?");
+			json_spirit::read_string(s, v);
+			dev::test::doVMUntracedTests(v);
+		}
+		catch (Exception const& _e)
+		{
+			BOOST_ERROR("Failed test with Exception: " << diagnostic_information(_e));
+		}
+		catch (std::exception const& _e)
+		{
+			BOOST_ERROR("Failed test with Exception: " << _e.what());
+		}
+	}
+}
+
 BOOST_AUTO_TEST_CASE(vmPerformanceTest)
 {
 	for (int i = 1; i < boost::unit_test::framework::master_test_suite().argc; ++i)